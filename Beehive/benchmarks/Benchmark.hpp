@@ -0,0 +1,79 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+// Registry and timing helpers of the benchmarks executable. A benchmark is a
+// function declared with BENCHMARK(Name) that measures its cases with
+// measure() and prints them with report().
+namespace Beehive {
+namespace Benchmark {
+
+typedef void (*Function)();
+
+class Registration {
+public:
+  Registration(const char *name, Function function);
+};
+
+// Minimum time a case runs for, long enough to hide the clock resolution
+// and warm the caches.
+const std::chrono::milliseconds MinTime(500);
+
+// Keeps the compiler from optimizing away a value that is otherwise unused.
+template<typename Value>
+inline void keep(const Value &value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Seconds per call of body, calling it in growing batches until a batch
+// lasts MinTime.
+template<typename Body>
+double measure(Body body) {
+  for (size_t iterations = 1;; iterations *= 2) {
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+      body();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    if (MinTime <= elapsed)
+      return elapsed.count() / iterations;
+  }
+}
+
+void report(const std::string &benchmark, const std::string &measurement, double value, const std::string &unit);
+
+} /* namespace Benchmark */
+} /* namespace Beehive */
+
+#define BENCHMARK(name) \
+  static void name##Benchmark(); \
+  static Beehive::Benchmark::Registration name##Registration(#name, name##Benchmark); \
+  static void name##Benchmark()
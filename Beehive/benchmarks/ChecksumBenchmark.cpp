@@ -0,0 +1,91 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Benchmark.hpp"
+
+#include <tcp/Checksum.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace Beehive::Services::TCP;
+
+namespace {
+
+// The byte at a time CRC-16/ARC the protocol used before the sliced
+// kernels, kept as the baseline.
+struct BytewiseCrc16 {
+  uint16_t table[256];
+
+  BytewiseCrc16() {
+    for (uint16_t i = 0; i < 256; i++) {
+      uint16_t crc = i;
+      for (int bit = 0; bit < 8; bit++)
+        crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+      table[i] = crc;
+    }
+  }
+
+  uint16_t operator()(uint16_t crc, const uint8_t *data, size_t size) const {
+    for (size_t i = 0; i < size; i++)
+      crc = (crc >> 8) ^ table[(crc ^ data[i]) & 0xff];
+    return crc;
+  }
+};
+
+double gigabytesPerSecond(size_t size, double seconds) {
+  return size / seconds / 1e9;
+}
+
+} /* namespace */
+
+BENCHMARK(Checksum) {
+  // 32 KB is the largest change payload, 256 bytes a typical small frame.
+  for (size_t size : { (size_t) 32768, (size_t) 256 }) {
+    std::vector<uint8_t> payload(size);
+    for (size_t i = 0; i < size; i++)
+      payload[i] = (uint8_t) (i * 131 + 7);
+    std::string label = " " + std::to_string(size) + " bytes";
+
+    BytewiseCrc16 bytewise;
+    double seconds = Beehive::Benchmark::measure([&] {
+      Beehive::Benchmark::keep(bytewise(0, payload.data(), payload.size()));
+    });
+    Beehive::Benchmark::report("Checksum", "crc16 bytewise" + label, gigabytesPerSecond(size, seconds), "GB/s");
+
+    seconds = Beehive::Benchmark::measure([&] {
+      Beehive::Benchmark::keep(crc16(0, payload.data(), payload.size()));
+    });
+    Beehive::Benchmark::report("Checksum", "crc16" + label, gigabytesPerSecond(size, seconds), "GB/s");
+
+    seconds = Beehive::Benchmark::measure([&] {
+      Beehive::Benchmark::keep(crc32c(0, payload.data(), payload.size()));
+    });
+    Beehive::Benchmark::report("Checksum", "crc32c" + label, gigabytesPerSecond(size, seconds), "GB/s");
+  }
+}
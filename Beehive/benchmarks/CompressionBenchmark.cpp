@@ -0,0 +1,181 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Benchmark.hpp"
+
+#include <sqlite/TextEncoder.hpp>
+#include <tcp/Compression.hpp>
+
+#include <stdlib.h>
+#include <zdict.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace Beehive::Services;
+
+namespace {
+
+const size_t Rows = 200;
+const size_t TrainingRows = 4000;
+const size_t DictionarySize = 16384;
+const char *Context = "benchmark";
+
+// Customer rows in the text form clients send in newData, from a small
+// vocabulary like real tables.
+std::vector<std::string> rows(size_t count, uint32_t seed) {
+  static const char *names[] = { "María", "José", "Ana", "Luis", "Carmen", "Jorge", "Lucía", "Pedro" };
+  static const char *surnames[] = { "García", "Hernández", "López", "Martínez", "González", "Pérez", "Sánchez" };
+  static const char *cities[] = { "Guadalajara", "Zapopan", "Monterrey", "Puebla", "Querétaro", "León" };
+  static const char *words[] = { "customer", "prefers", "delivery", "in", "the", "morning", "pays", "cash", "credit", "monthly" };
+  const std::unordered_map<int, std::string> columns = {
+    { 0, "id" }, { 1, "name" }, { 2, "street" }, { 3, "city" }, { 4, "phone" }, { 5, "email" }, { 6, "balance" }, { 7, "active" },
+    { 8, "notes" }
+  };
+  std::vector<std::string> rows;
+  uint32_t state = seed;
+  auto next = [&state]() {
+    state = state * 1664525 + 1013904223;
+    return state >> 8;
+  };
+  for (size_t i = 0; i < count; i++) {
+    SqLite::TextEncoder encoder(columns);
+    std::string name = std::string(names[next() % 8]) + " " + surnames[next() % 7];
+    encoder.addInteger(0, seed + i);
+    encoder.addText(1, name);
+    encoder.addText(2, "Calle " + std::to_string(next() % 500) + " #" + std::to_string(next() % 3000));
+    encoder.addText(3, cities[next() % 6]);
+    encoder.addText(4, "+52 33 " + std::to_string(1000 + next() % 9000) + " " + std::to_string(1000 + next() % 9000));
+    encoder.addText(5, "customer" + std::to_string(seed + i) + "@example.com");
+    encoder.addReal(6, (next() % 1000000) / 100.0);
+    encoder.addInteger(7, next() % 2);
+    std::string notes;
+    for (uint32_t word = next() % 12; 0 < word; word--)
+      notes += std::string(words[next() % 10]) + " ";
+    encoder.addText(8, notes);
+    rows.push_back(encoder.encodedData());
+  }
+  return rows;
+}
+
+// Dictionary trained like zstd --train over rows that are not benchmarked,
+// stored where Dictionary::get() looks for it.
+std::shared_ptr<const TCP::Dictionary> dictionary(const std::string &directory) {
+  std::vector<std::string> samples = rows(TrainingRows, 7);
+  std::string buffer;
+  std::vector<size_t> sizes;
+  for (const std::string &sample : samples) {
+    buffer += sample;
+    sizes.push_back(sample.size());
+  }
+  std::string dictionary(DictionarySize, '\0');
+  size_t size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), buffer.data(), sizes.data(), sizes.size());
+  if (ZDICT_isError(size))
+    return nullptr;
+  std::ofstream(directory + "/" + Context + ".dict", std::ios::binary).write(dictionary.data(), size);
+  TCP::Dictionary::directory(directory);
+  return TCP::Dictionary::get(Context);
+}
+
+struct Case {
+  std::string name;
+  TCP::Compression algorithm;
+  std::shared_ptr<const TCP::Dictionary> dictionary;
+};
+
+} /* namespace */
+
+BENCHMARK(Compression) {
+  char directory[] = "/tmp/beehive-dictionary-XXXXXX";
+  std::shared_ptr<const TCP::Dictionary> trained;
+  if (mkdtemp(directory) != nullptr)
+    trained = dictionary(directory);
+
+  std::vector<Case> cases = {
+    { "none", TCP::Compression::None, nullptr },
+    { "lz4", TCP::Compression::LZ4, nullptr },
+    { "zstd", TCP::Compression::ZSTD, nullptr }
+  };
+  if (trained)
+    cases.push_back({ "zstd dictionary", TCP::Compression::ZSTD, trained });
+
+  const std::vector<std::string> benchmarked = rows(Rows, 1);
+  // One change per frame as in a live sync, and 100 per frame as in an
+  // initial download.
+  for (size_t rowsPerFrame : { (size_t) 1, (size_t) 100 }) {
+    std::vector<std::vector<uint8_t>> frames;
+    for (size_t i = 0; i < benchmarked.size(); i += rowsPerFrame) {
+      std::vector<uint8_t> frame;
+      for (size_t row = i; row < i + rowsPerFrame && row < benchmarked.size(); row++)
+        frame.insert(frame.end(), benchmarked[row].begin(), benchmarked[row].end());
+      frames.push_back(std::move(frame));
+    }
+    std::string label = " " + std::to_string(rowsPerFrame) + (rowsPerFrame == 1 ? " row/frame" : " rows/frame");
+
+    for (const Case &c : cases) {
+      TCP::Compressor compressor;
+      compressor.dictionary(c.dictionary);
+      size_t bytes = 0;
+      std::vector<std::vector<uint8_t>> compressed(frames.size());
+      for (size_t i = 0; i < frames.size(); i++) {
+        if (c.algorithm == TCP::Compression::None)
+          compressed[i] = frames[i];
+        else
+          compressor.compress(c.algorithm, frames[i].data(), frames[i].size(), compressed[i]);
+        bytes += compressed[i].size();
+      }
+      Beehive::Benchmark::report("Compression", c.name + label, (double) bytes / Rows, "bytes/row");
+      if (c.algorithm == TCP::Compression::None)
+        continue;
+
+      std::vector<uint8_t> output;
+      double seconds = Beehive::Benchmark::measure([&] {
+        for (const std::vector<uint8_t> &frame : frames) {
+          output.clear();
+          compressor.compress(c.algorithm, frame.data(), frame.size(), output);
+        }
+      });
+      Beehive::Benchmark::report("Compression", c.name + label + " compress", seconds / Rows * 1e9, "ns/row");
+      seconds = Beehive::Benchmark::measure([&] {
+        for (size_t i = 0; i < frames.size(); i++) {
+          output.clear();
+          compressor.decompress(c.algorithm, compressed[i].data(), compressed[i].size(), frames[i].size(), output);
+        }
+      });
+      Beehive::Benchmark::report("Compression", c.name + label + " decompress", seconds / Rows * 1e9, "ns/row");
+    }
+  }
+
+  trained.reset();
+  TCP::Dictionary::directory("");
+  std::filesystem::remove_all(directory);
+}
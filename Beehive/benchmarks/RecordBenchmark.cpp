@@ -0,0 +1,99 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Benchmark.hpp"
+
+#include <dao/Record.hpp>
+#include <entities/Node.hpp>
+#include <entities/User.hpp>
+
+#include <json/json.hpp>
+
+#include <string>
+
+using namespace Beehive::Services;
+
+namespace {
+
+const double Nanoseconds = 1e9;
+
+// Encodes and decodes an entity both ways: the binary record and the JSON
+// document the DAOs stored before.
+template<typename Entity>
+void compare(const std::string &name, const Entity &entity) {
+  std::string record = DAO::Record::encode(entity);
+  std::string json = nlohmann::json(entity).dump();
+  Beehive::Benchmark::report("Record", name + " record size", record.size(), "bytes");
+  Beehive::Benchmark::report("Record", name + " json size", json.size(), "bytes");
+
+  double seconds = Beehive::Benchmark::measure([&] {
+    Beehive::Benchmark::keep(DAO::Record::encode(entity));
+  });
+  Beehive::Benchmark::report("Record", name + " encode record", seconds * Nanoseconds, "ns/op");
+  seconds = Beehive::Benchmark::measure([&] {
+    Beehive::Benchmark::keep(nlohmann::json(entity).dump());
+  });
+  Beehive::Benchmark::report("Record", name + " encode json", seconds * Nanoseconds, "ns/op");
+
+  seconds = Beehive::Benchmark::measure([&] {
+    Entity decoded;
+    DAO::Record::decode(record, decoded);
+    Beehive::Benchmark::keep(decoded);
+  });
+  Beehive::Benchmark::report("Record", name + " decode record", seconds * Nanoseconds, "ns/op");
+  // Through Record::decode, which is how values written before the binary
+  // format are still read.
+  seconds = Beehive::Benchmark::measure([&] {
+    Entity decoded;
+    DAO::Record::decode(json, decoded);
+    Beehive::Benchmark::keep(decoded);
+  });
+  Beehive::Benchmark::report("Record", name + " decode json", seconds * Nanoseconds, "ns/op");
+}
+
+} /* namespace */
+
+BENCHMARK(Record) {
+  Entities::User user;
+  user.uuid("4a9c2f43-7c3f-4b7e-9a52-1f0c8e2d6b11");
+  user.identifier("someone@example.com");
+  user.name("Someone With A Name");
+  user.type(Entities::User::Type::google);
+  user.password("$argon2id$v=19$m=65536,t=2,p=1$c29tZXNhbHQ$RdescudvJCsgt3ub+b+dWRWJTmaaJObG");
+  user.salt("c29tZXNhbHQ");
+  compare("user", user);
+
+  // Read on every reconnect of a node.
+  Entities::Node node;
+  node.user(user);
+  node.key(std::string(32, '\x5a'));
+  node.context("2f7a9e14-5b3c-4d8e-a6f1-7c0b9d3e5a24");
+  node.module("9d3e57a0-2f1b-4c7d-8e6f-0a1b2c3d4e5f");
+  node.uuid("0b6f3e2a-9c41-4d7e-8a15-3e9f6c2d1b70");
+  node.version(12);
+  compare("node", node);
+}
@@ -0,0 +1,240 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Benchmark.hpp"
+
+#include <dao/KeyCodec.hpp>
+#include <dao/Record.hpp>
+#include <dao/Storage.hpp>
+#include <dao/StorageProfile.hpp>
+#include <entities/ChangeView.hpp>
+#include <entities/Header.hpp>
+#include <entities/User.hpp>
+#include <sqlite/Types.hpp>
+
+#include <rocksdb/db.h>
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Beehive::Services;
+
+namespace {
+
+// db_bench style workloads over the keys the DAOs write: users and their
+// uuid index in the default family, and headers with their changes in a
+// context family.
+const uint32_t Datasets = 100;
+const uint32_t HeadersPerDataset = 100;
+const uint16_t ChangesPerHeader = 10;
+const uint32_t Users = 10000;
+const char *ContextFamily = "2f7a9e14-5b3c-4d8e-a6f1-7c0b9d3e5a24";
+
+std::string userUUID(uint32_t user) {
+  char uuid[37];
+  snprintf(uuid, sizeof(uuid), "%08x-0000-4000-8000-%012x", user, user * 7919);
+  return uuid;
+}
+
+std::string identifier(uint32_t user) {
+  return "user" + std::to_string(user) + "@example.com";
+}
+
+std::string headerKey(uint32_t idDataset, uint32_t idHeader) {
+  return DAO::KeyCodec("H.").putUint32(idDataset).putUint32(idHeader).key();
+}
+
+// A database in its own temporary directory opened with the options of a
+// storage profile, or with the RocksDB defaults for the "baseline".
+class Database {
+public:
+  Database(const std::string &profile) {
+    char directory[] = "/tmp/beehive-storage-XXXXXX";
+    if (mkdtemp(directory) == nullptr)
+      throw DAO::StorageException("Unable to create the benchmark directory.", 0);
+    _path = directory;
+    rocksdb::DBOptions options;
+    std::vector<rocksdb::ColumnFamilyDescriptor> families;
+    if (profile == "baseline") {
+      families.emplace_back(rocksdb::kDefaultColumnFamilyName, rocksdb::ColumnFamilyOptions());
+      families.emplace_back(ContextFamily, rocksdb::ColumnFamilyOptions());
+    } else {
+      DAO::StorageProfile storageProfile = DAO::StorageProfile::load(profile);
+      options = storageProfile.dbOptions();
+      families.emplace_back(rocksdb::kDefaultColumnFamilyName, storageProfile.familyOptions(DAO::Storage::DefaultContext));
+      families.emplace_back(ContextFamily, storageProfile.familyOptions(ContextFamily));
+    }
+    options.create_if_missing = true;
+    options.create_missing_column_families = true;
+    rocksdb::Status status = rocksdb::DB::Open(options, _path, families, &_handles, &_db);
+    if (!status.ok())
+      throw DAO::StorageException("Unable to open the benchmark database: " + status.ToString(), 0);
+  }
+
+  ~Database() {
+    for (rocksdb::ColumnFamilyHandle *handle : _handles)
+      _db->DestroyColumnFamilyHandle(handle);
+    delete _db;
+    std::filesystem::remove_all(_path);
+  }
+
+  rocksdb::DB *db() const {
+    return _db;
+  }
+
+  rocksdb::ColumnFamilyHandle *system() const {
+    return _handles[0];
+  }
+
+  rocksdb::ColumnFamilyHandle *context() const {
+    return _handles[1];
+  }
+
+  // Moves everything to SST files, so reads go through the block cache and
+  // the filters like on a long running server.
+  void settle() {
+    for (rocksdb::ColumnFamilyHandle *handle : _handles) {
+      _db->Flush(rocksdb::FlushOptions(), handle);
+      _db->CompactRange(rocksdb::CompactRangeOptions(), handle, nullptr, nullptr);
+    }
+  }
+
+private:
+  std::string _path;
+  rocksdb::DB *_db;
+  std::vector<rocksdb::ColumnFamilyHandle*> _handles;
+};
+
+double fill(Database &database) {
+  std::string row;
+  for (int i = 0; i < 12; i++)
+    row += "{\"column" + std::to_string(i) + "\":\"value " + std::to_string(i * 37) + "\"}";
+
+  auto begin = std::chrono::steady_clock::now();
+  size_t keys = 0;
+  for (uint32_t user = 0; user < Users; user++) {
+    Entities::User entity;
+    entity.uuid(userUUID(user));
+    entity.identifier(identifier(user));
+    entity.name("User " + std::to_string(user));
+    entity.type(Entities::User::Type::google);
+    rocksdb::WriteBatch batch;
+    batch.Put(database.system(), "U." + entity.identifier(), DAO::Record::encode(entity));
+    batch.Put(database.system(), DAO::KeyCodec("U.IX.").putUUID(entity.uuid()).key(), entity.identifier());
+    database.db()->Write(rocksdb::WriteOptions(), &batch);
+    keys += 2;
+  }
+  // One batch per header like StorageService, without the sync so the
+  // numbers compare the profiles and not the disk.
+  for (uint32_t idDataset = 0; idDataset < Datasets; idDataset++) {
+    for (uint32_t idHeader = 0; idHeader < HeadersPerDataset; idHeader++) {
+      rocksdb::WriteBatch batch;
+      Entities::Header header;
+      header.idDataset(idDataset);
+      header.idHeader(idHeader);
+      header.transactionUUID(ContextFamily);
+      header.node(idDataset);
+      header.idNode(idHeader);
+      header.status(1);
+      header.version(1);
+      batch.Put(database.context(), headerKey(idDataset, idHeader), DAO::Record::encode(header));
+      for (uint16_t idChange = 0; idChange < ChangesPerHeader; idChange++) {
+        std::string pk = std::to_string(idHeader * ChangesPerHeader + idChange);
+        Entities::ChangeView change;
+        change.operation(SqLite::Operation::Insert);
+        change.entityUUID(ContextFamily);
+        change.newPK(pk);
+        change.newData(row);
+        batch.Put(database.context(), DAO::KeyCodec("C.").putUint32(idDataset).putUint32(idHeader).putUint16(idChange).key(),
+            DAO::Record::encode(change));
+      }
+      database.db()->Write(rocksdb::WriteOptions(), &batch);
+      keys += 1 + ChangesPerHeader;
+    }
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+  return keys / elapsed.count();
+}
+
+} /* namespace */
+
+BENCHMARK(Storage) {
+  for (const char *profile : { "baseline", "default", "write-heavy", "read-heavy", "small" }) {
+    Database database(profile);
+    std::string name(profile);
+    Beehive::Benchmark::report("Storage", name + " fill", fill(database), "keys/s");
+    database.settle();
+
+    std::mt19937 random(42);
+    rocksdb::ReadOptions options;
+    std::string value;
+    double seconds = Beehive::Benchmark::measure([&] {
+      std::string key = headerKey(random() % Datasets, random() % HeadersPerDataset);
+      Beehive::Benchmark::keep(database.db()->Get(options, database.context(), key, &value).ok());
+    });
+    Beehive::Benchmark::report("Storage", name + " readrandom header", 1 / seconds, "ops/s");
+
+    // Headers a node has not synchronized yet, answered by the filters.
+    seconds = Beehive::Benchmark::measure([&] {
+      std::string key = headerKey(random() % Datasets, HeadersPerDataset + random() % HeadersPerDataset);
+      Beehive::Benchmark::keep(database.db()->Get(options, database.context(), key, &value).ok());
+    });
+    Beehive::Benchmark::report("Storage", name + " readmissing header", 1 / seconds, "ops/s");
+
+    // The changes of a header, like ChangeDAO::readByHeader.
+    seconds = Beehive::Benchmark::measure([&] {
+      DAO::KeyCodec prefix("C.");
+      prefix.putUint32(random() % Datasets).putUint32(random() % HeadersPerDataset);
+      std::string upperBound = prefix.successor();
+      rocksdb::Slice upperBoundSlice(upperBound);
+      rocksdb::ReadOptions scanOptions;
+      scanOptions.iterate_upper_bound = &upperBoundSlice;
+      std::unique_ptr<rocksdb::Iterator> iterator(database.db()->NewIterator(scanOptions, database.context()));
+      size_t changes = 0;
+      for (iterator->Seek(prefix.key()); iterator->Valid(); iterator->Next())
+        changes++;
+      Beehive::Benchmark::keep(changes);
+    });
+    Beehive::Benchmark::report("Storage", name + " scan header changes", 1 / seconds, "ops/s");
+
+    // Sign in of a node: the user by uuid through the index.
+    seconds = Beehive::Benchmark::measure([&] {
+      std::string identifier;
+      std::string key = DAO::KeyCodec("U.IX.").putUUID(userUUID(random() % Users)).key();
+      if (database.db()->Get(options, database.system(), key, &identifier).ok())
+        Beehive::Benchmark::keep(database.db()->Get(options, database.system(), "U." + identifier, &value).ok());
+    });
+    Beehive::Benchmark::report("Storage", name + " read user by uuid", 1 / seconds, "ops/s");
+  }
+}
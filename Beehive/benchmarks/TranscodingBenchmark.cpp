@@ -0,0 +1,119 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Benchmark.hpp"
+
+#include <memory/Arena.hpp>
+#include <sqlite/BinaryEncoder.hpp>
+#include <sqlite/ColumnCodec.hpp>
+#include <sqlite/TextDecoder.hpp>
+#include <sqlite/TextEncoder.hpp>
+#include <string/ICaseMap.hpp>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace Beehive::Services;
+
+namespace {
+
+// Columns of a typical synchronized table as declared in the schema. Rows
+// name them in lower case, as the clients' SQLite reports them.
+const char *Columns[] = {
+  "Id", "CustomerName", "Street", "City", "State", "ZipCode", "Phone", "Email", "Balance", "CreditLimit", "Notes", "Active",
+  "CreatedAt", "UpdatedAt", "Photo", "Deleted"
+};
+
+std::string lower(std::string name) {
+  for (char &c : name)
+    c = (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+  return name;
+}
+
+} /* namespace */
+
+BENCHMARK(Transcoding) {
+  std::unordered_map<std::string, int, Utils::IHasher, Utils::IEqualsComparator> name2Id;
+  std::unordered_map<int, std::string> id2Name;
+  int id = 0;
+  for (const char *column : Columns) {
+    name2Id.emplace(column, id);
+    id2Name.emplace(id, lower(column));
+    id++;
+  }
+  SqLite::ColumnCodec codec(name2Id);
+
+  SqLite::TextEncoder encoder(id2Name);
+  encoder.addInteger(0, 123456);
+  encoder.addText(1, "Customer with a reasonably long name");
+  encoder.addText(2, "Avenida Vallarta 1234");
+  encoder.addText(3, "Guadalajara");
+  encoder.addText(4, "Jalisco");
+  encoder.addText(5, "44100");
+  encoder.addText(6, "+52 33 1234 5678");
+  encoder.addText(7, "customer@example.com");
+  encoder.addReal(8, 10500.75);
+  encoder.addReal(9, 50000);
+  encoder.addText(10, std::string(200, 'n'));
+  encoder.addInteger(11, 1);
+  encoder.addInteger(12, 1700000000);
+  encoder.addInteger(13, 1700000500);
+  encoder.addBlob(14, std::string(512, '\x7f'));
+  encoder.addNull(15);
+  const std::string row = encoder.encodedData();
+
+  std::vector<std::string> names;
+  for (SqLite::TextDecoder::Value &value : SqLite::TextDecoder(row.data(), row.size(), codec, "Customer"))
+    names.emplace_back(value.column());
+
+  // Name resolution alone, per field through the case insensitive hash map
+  // the decoder used before and through the compiled codec.
+  double seconds = Beehive::Benchmark::measure([&] {
+    for (const std::string &name : names)
+      Beehive::Benchmark::keep(name2Id.find(name)->second);
+  });
+  Beehive::Benchmark::report("Transcoding", "resolve columns ICaseMap", 1 / seconds, "rows/s");
+  seconds = Beehive::Benchmark::measure([&] {
+    for (const std::string &name : names)
+      Beehive::Benchmark::keep(codec.find(name));
+  });
+  Beehive::Benchmark::report("Transcoding", "resolve columns ColumnCodec", 1 / seconds, "rows/s");
+
+  // The whole text to binary transcoding of an insert.
+  Memory::Arena arena(16384);
+  seconds = Beehive::Benchmark::measure([&] {
+    SqLite::TextDecoder decoder(row.data(), row.size(), codec, "Customer");
+    SqLite::BinaryEncoder binary(arena.resource());
+    for (SqLite::TextDecoder::Value &value : decoder)
+      binary.addValue(value);
+    Beehive::Benchmark::keep(binary.encodedData(arena));
+    arena.reset();
+  });
+  Beehive::Benchmark::report("Transcoding", "text to binary " + std::to_string(row.size()) + " byte row", 1 / seconds, "rows/s");
+}
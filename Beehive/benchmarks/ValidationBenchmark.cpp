@@ -0,0 +1,162 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Benchmark.hpp"
+
+#include <config/Context.hpp>
+#include <dao/Storage.hpp>
+#include <entities/ChangeView.hpp>
+#include <entities/Header.hpp>
+#include <sqlite/BinaryEncoder.hpp>
+#include <sqlite/Types.hpp>
+#include <validation/LuaPool.hpp>
+#include <validation/TransactionsManager.hpp>
+
+#include <json/json.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Beehive::Services;
+
+namespace {
+
+const char *EntitySchema = R"({
+  "uuid": "6d1c1f0e-3b9a-4c2e-9f57-0c4f2a7e8b10",
+  "name": "Customer",
+  "keys": [ { "id": 0, "name": "Id", "type": "Integer" } ],
+  "attributes": [
+    { "id": 1, "name": "Name", "type": "Text" },
+    { "id": 2, "name": "City", "type": "Text" },
+    { "id": 3, "name": "Balance", "type": "Real" },
+    { "id": 4, "name": "Active", "type": "Integer" },
+    { "id": 5, "name": "Notes", "type": "Text" }
+  ]
+})";
+
+const char *TransactionUUID = "0b6f3e2a-9c41-4d7e-8a15-3e9f6c2d1b70";
+
+// Reads every attribute of every change, like the usual validation script
+// that checks each row before accepting the header.
+const char *Script = R"(
+local total = 0
+for _, change in ipairs(data) do
+  local row = change.new or change.old
+  if row.Name == nil or #row.Name == 0 or row.City == nil then
+    return false
+  end
+  if change.old ~= nil and change.old.Id ~= row.Id then
+    return false
+  end
+  total = total + row.Balance + row.Active + #row.Notes
+end
+return total >= 0
+)";
+
+std::shared_ptr<Config::Context> context() {
+  auto context = std::make_shared<Config::Context>();
+  context->uuid = "2f7a9e14-5b3c-4d8e-a6f1-7c0b9d3e5a24";
+  context->name = "Benchmark";
+  context->version = 1;
+  Config::Entity entity = nlohmann::json::parse(EntitySchema).get<Config::Entity>();
+  context->entitiesName2UUID.emplace(entity.name, entity.uuid);
+  context->entities.emplace(entity.uuid, std::move(entity));
+  Config::Transaction transaction;
+  transaction.uuid = TransactionUUID;
+  transaction.name = "Benchmark";
+  transaction.pre = Script;
+  transaction.preBytecode = Utils::LuaPool::compile(transaction.uuid, transaction.pre);
+  context->transactionsName2UUID.emplace(transaction.name, transaction.uuid);
+  context->transactions.emplace(transaction.uuid, std::move(transaction));
+  return context;
+}
+
+std::string key(int id) {
+  SqLite::BinaryEncoder encoder;
+  encoder.addInteger(0, id);
+  return encoder.encodedData();
+}
+
+std::string row(int id) {
+  SqLite::BinaryEncoder encoder;
+  encoder.addText(1, "Customer " + std::to_string(id));
+  encoder.addText(2, "Guadalajara");
+  encoder.addReal(3, id * 1.5);
+  encoder.addInteger(4, id % 2);
+  encoder.addText(5, std::string(100, 'n'));
+  return encoder.encodedData();
+}
+
+} /* namespace */
+
+BENCHMARK(Validation) {
+  std::shared_ptr<Config::Context> validationContext = context();
+  const std::string &entityUUID = validationContext->entities.begin()->first;
+
+  // Half inserts and half updates, so the scripts see new and old rows.
+  for (int count : { 1000, 10000 }) {
+    std::vector<std::string> data;
+    data.reserve(count * 2);
+    Entities::Header header;
+    header.idDataset(1);
+    header.transactionUUID(TransactionUUID);
+    for (int i = 0; i < count; i++) {
+      data.push_back(key(i));
+      data.push_back(row(i));
+      Entities::ChangeView change;
+      change.entityUUID(entityUUID);
+      change.newPK(data[data.size() - 2]);
+      change.newData(data.back());
+      if (i % 2 == 0) {
+        change.operation(SqLite::Operation::Insert);
+      } else {
+        change.operation(SqLite::Operation::Update);
+        change.oldPK(data[data.size() - 2]);
+        change.oldData(data.back());
+      }
+      header.changes().push_back(change);
+    }
+
+    // The storage is not opened: the scripts only validate, so they never
+    // reach the column family.
+    DAO::Storage::ContextHandle storage;
+    Utils::TransactionsManager manager;
+    manager.context(validationContext);
+    bool valid = true;
+    double seconds = Beehive::Benchmark::measure([&] {
+      DAO::Storage::Batch batch;
+      valid = manager.executeValidation(header, storage, batch) && valid;
+      manager.executeCommit(header, storage, batch);
+    });
+    if (!valid)
+      Beehive::Benchmark::report("Validation", "script rejected the header", 0, "");
+    std::string label = "header of " + std::to_string(count) + " changes";
+    Beehive::Benchmark::report("Validation", label, count / seconds, "changes/s");
+    Beehive::Benchmark::report("Validation", label, seconds * 1e3, "ms/header");
+  }
+}
@@ -0,0 +1,80 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Benchmark.hpp"
+
+#include <nanolog/NanoLog.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace Beehive {
+namespace Benchmark {
+
+static std::vector<std::pair<const char*, Function>>& benchmarks() {
+  static std::vector<std::pair<const char*, Function>> benchmarks;
+  return benchmarks;
+}
+
+Registration::Registration(const char *name, Function function) {
+  benchmarks().emplace_back(name, function);
+}
+
+void report(const std::string &benchmark, const std::string &measurement, double value, const std::string &unit) {
+  std::printf("%-12s %-40s %14.2f %s\n", benchmark.c_str(), measurement.c_str(), value, unit.c_str());
+  std::fflush(stdout);
+}
+
+} /* namespace Benchmark */
+} /* namespace Beehive */
+
+int main(int argc, char **argv) {
+  // The modules log through NanoLog, which must be initialized before any
+  // warning of a benchmarked path, e.g. a script that fails to load.
+  nanolog::initialize(nanolog::GuaranteedLogger(), "/tmp/", "beehive-benchmarks", 1);
+  nanolog::set_log_level(nanolog::LogLevel::WARN);
+  int run = 0;
+  for (auto &benchmark : Beehive::Benchmark::benchmarks()) {
+    bool selected = argc == 1;
+    for (int i = 1; i < argc && !selected; i++)
+      selected = strcmp(argv[i], benchmark.first) == 0;
+    if (selected) {
+      benchmark.second();
+      run++;
+    }
+  }
+  if (run == 0) {
+    std::fprintf(stderr, "Usage: %s [benchmark...]\nBenchmarks:", argv[0]);
+    for (auto &benchmark : Beehive::Benchmark::benchmarks())
+      std::fprintf(stderr, " %s", benchmark.first);
+    std::fprintf(stderr, "\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,110 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <services/ServiceException.hpp>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Beehive {
+namespace Services {
+namespace Config {
+
+// Id keyed table for schema attributes. Entries are kept ordered by id like a
+// std::map, and a dense id to position index makes find() a single array read.
+template <typename T>
+class DenseMap {
+   public:
+    using value_type = std::pair<int, T>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    static constexpr int MaxId = 0xffff;
+
+    bool emplace(int id, const T &value) {
+        if (id < 0 || id > MaxId)
+            throw InvalidSchemaException("Invalid attribute id " + std::to_string(id));
+        if (find(id) != end())
+            return false;
+        auto position = std::lower_bound(_items.begin(), _items.end(), id, [](const value_type &item, int id) {
+            return item.first < id;
+        });
+        _items.emplace(position, id, value);
+        if (_index.size() <= (size_t)id)
+            _index.resize(id + 1, -1);
+        for (size_t i = 0; i < _items.size(); ++i)
+            _index[_items[i].first] = i;
+        return true;
+    }
+
+    iterator find(int id) {
+        if (id < 0 || (size_t)id >= _index.size() || _index[id] < 0)
+            return _items.end();
+        return _items.begin() + _index[id];
+    }
+
+    const_iterator find(int id) const {
+        if (id < 0 || (size_t)id >= _index.size() || _index[id] < 0)
+            return _items.end();
+        return _items.begin() + _index[id];
+    }
+
+    iterator begin() {
+        return _items.begin();
+    }
+
+    iterator end() {
+        return _items.end();
+    }
+
+    const_iterator begin() const {
+        return _items.begin();
+    }
+
+    const_iterator end() const {
+        return _items.end();
+    }
+
+    size_t size() const {
+        return _items.size();
+    }
+
+    bool empty() const {
+        return _items.empty();
+    }
+
+   private:
+    std::vector<value_type> _items;
+    std::vector<int> _index;
+};
+
+} /* namespace Config */
+} /* namespace Services */
+} /* namespace Beehive */
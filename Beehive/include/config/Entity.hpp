@@ -28,6 +28,8 @@ SOFTWARE.
 #pragma once
 
 #include <json/Common.hpp>
+#include <config/DenseMap.hpp>
+#include <sqlite/ColumnCodec.hpp>
 #include <sqlite/Types.hpp>
 #include <string/ICaseMap.hpp>
 #include <validation/Validator.hpp>
@@ -140,12 +142,14 @@ struct Entity {
     std::string name;
     std::vector<Entity::Key> jsonKeys;
     std::vector<Entity::Attribute> jsonAttributes;
-    std::map<int, Key> keys;
-    std::map<int, Attribute> attributes;
+    DenseMap<Key> keys;
+    DenseMap<Attribute> attributes;
     std::unordered_map<int, std::string> keysId2Name;
     std::unordered_map<int, std::string> attributesId2Name;
     std::unordered_map<std::string, int, Utils::IHasher, Utils::IEqualsComparator> keysName2Id;
     std::unordered_map<std::string, int, Utils::IHasher, Utils::IEqualsComparator> attributesName2Id;
+    SqLite::ColumnCodec keysCodec;
+    SqLite::ColumnCodec attributesCodec;
     std::unordered_map<std::string, Transaction, Utils::IHasher, Utils::IEqualsComparator> transactions;
 };
 
@@ -210,6 +214,8 @@ inline void from_json(const json &j, Entity &x) {
         x.attributesId2Name.emplace(attribute.id, attribute.name);
         x.attributesName2Id.emplace(attribute.name, attribute.id);
     }
+    x.keysCodec = Beehive::Services::SqLite::ColumnCodec(x.keysName2Id);
+    x.attributesCodec = Beehive::Services::SqLite::ColumnCodec(x.attributesName2Id);
 }
 
 inline void to_json(json &j, const Entity &x) {
@@ -48,6 +48,8 @@ struct Transaction {
     std::vector<Entity> entities;
     std::string pre;
     std::string post;
+    std::string preBytecode;
+    std::string postBytecode;
 };
 
 } /* namespace Config */
@@ -27,10 +27,12 @@ SOFTWARE.
 
 #pragma once
 
+#include <dao/Storage.hpp>
 #include <config/Entity.hpp>
 #include <config/Module.hpp>
 #include <config/Role.hpp>
 #include <entities/Change.hpp>
+#include <entities/ChangeView.hpp>
 
 #include <memory>
 #include <unordered_map>
@@ -46,8 +48,9 @@ class ChangeDAO {
       ChangeDAO() {
       }
 
-      void save(Entities::Change &change, const std::string &context);
-      std::vector<Entities::Change> readByHeader(uint32_t idDataset, uint32_t idHeader, const std::unordered_map<std::string, Config::Entity, Utils::IHasher, Utils::IEqualsComparator> &entities, const std::unordered_map<std::string, std::unordered_set<int>> &entitiesByNode, const std::string &context);
+      void save(Entities::ChangeView &change, const Storage::ContextHandle &context);
+      void save(Entities::ChangeView &change, const Storage::ContextHandle &context, Storage::Batch &batch);
+      std::vector<Entities::Change> readByHeader(uint32_t idDataset, uint32_t idHeader, const std::unordered_map<std::string, Config::Entity, Utils::IHasher, Utils::IEqualsComparator> &entities, const std::unordered_map<std::string, std::unordered_set<int>> &entitiesByNode, const Storage::ContextHandle &context);
 
    private:
       static std::string prefix;
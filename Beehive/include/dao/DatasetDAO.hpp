@@ -27,6 +27,7 @@ SOFTWARE.
 
 #pragma once
 
+#include <dao/Storage.hpp>
 #include <entities/Dataset.hpp>
 
 #include <memory>
@@ -41,10 +42,11 @@ class DatasetDAO {
       DatasetDAO() {
       }
       void save(Entities::Dataset &dataset, const std::string &context);
-      std::unique_ptr<Entities::Dataset> read(uint32_t id, const std::string &context);
+      std::unique_ptr<Entities::Dataset> read(uint32_t id, const Storage::ContextHandle &context);
       std::unique_ptr<Entities::Dataset> read(std::string &uuid, const std::string &context);
       std::vector<Entities::Dataset> readByUser(std::string uuidUser, const std::string &context);
-      int update(Entities::Dataset &dataset, const std::string &context);
+      int update(Entities::Dataset &dataset, const Storage::ContextHandle &context);
+      int update(Entities::Dataset &dataset, const Storage::ContextHandle &context, Storage::Batch &batch);
       int remove(uint32_t id, const std::string &context);
 
    private:
@@ -27,6 +27,8 @@ SOFTWARE.
 
 #pragma once
 
+#include <dao/Storage.hpp>
+
 #include <memory>
 
 namespace Beehive {
@@ -37,8 +39,9 @@ class DownloadedDAO {
    public:
       DownloadedDAO() {
       }
-      void save(std::string uuidNode, uint32_t idDataset, uint32_t idHeader, uint32_t idCell, const std::string &context);
-      std::pair<uint32_t, uint32_t> read(std::string uuidNode, uint32_t idDataset, const std::string &context);
+      void save(std::string uuidNode, uint32_t idDataset, uint32_t idHeader, uint32_t idCell, const Storage::ContextHandle &context);
+      void save(std::string uuidNode, uint32_t idDataset, uint32_t idHeader, uint32_t idCell, const Storage::ContextHandle &context, Storage::Batch &batch);
+      std::pair<uint32_t, uint32_t> read(std::string uuidNode, uint32_t idDataset, const Storage::ContextHandle &context);
 
    private:
       static std::string prefix;
@@ -28,7 +28,8 @@ SOFTWARE.
 #pragma once
 
 #include <config/Entity.hpp>
-#include <entities/Change.hpp>
+#include <dao/Storage.hpp>
+#include <entities/ChangeView.hpp>
 #include <entities/KeyData.hpp>
 
 #include <memory>
@@ -49,15 +50,17 @@ class EntityDAO {
     std::string uuidt2bin(std::string uuid);
     std::string bin2uuid1(std::string uuid);
     std::string bin2uuidt(std::string uuid);
-    void *read(uint32_t idDataset, const Config::Entity &entity, const std::string &context);
-    std::vector<Entities::KeyData> read(uint32_t idDataset, const sol::table &data, const Config::Entity &entity, const std::string &context);
-    Entities::KeyData read(Entities::Change &change, const Config::Entity &entity, const std::string &context);
-    int save(uint32_t idDataset, const sol::table &data, const Config::Entity &entity, const std::string &context);
-    void save(Entities::Change &change, const Config::Entity &entity, const std::string &context);
-    int update(uint32_t idDataset, const sol::table &key, const sol::table &data, const Config::Entity &entity, const std::string &context);
-    int update(Entities::Change &change, const Config::Entity &entity, const std::string &context);
-    int remove(uint32_t idDataset, const sol::table &key, const Config::Entity &entity, const std::string &context);
-    int remove(Entities::Change &change, const Config::Entity &entity, const std::string &context);
+    void *read(uint32_t idDataset, const Config::Entity &entity, const Storage::ContextHandle &context);
+    std::vector<Entities::KeyData> read(uint32_t idDataset, const sol::table &data, const Config::Entity &entity, const Storage::ContextHandle &context);
+    Entities::KeyData read(Entities::ChangeView &change, const Config::Entity &entity, const Storage::ContextHandle &context);
+    // Writes are added to the batch of the header being applied, so they are
+    // committed together with it.
+    int save(uint32_t idDataset, const sol::table &data, const Config::Entity &entity, const Storage::ContextHandle &context, Storage::Batch &batch);
+    void save(Entities::ChangeView &change, const Config::Entity &entity, const Storage::ContextHandle &context, Storage::Batch &batch);
+    int update(uint32_t idDataset, const sol::table &key, const sol::table &data, const Config::Entity &entity, const Storage::ContextHandle &context, Storage::Batch &batch);
+    int update(Entities::ChangeView &change, const Config::Entity &entity, const Storage::ContextHandle &context, Storage::Batch &batch);
+    int remove(uint32_t idDataset, const sol::table &key, const Config::Entity &entity, const Storage::ContextHandle &context, Storage::Batch &batch);
+    int remove(Entities::ChangeView &change, const Config::Entity &entity, const Storage::ContextHandle &context, Storage::Batch &batch);
 
    private:
     std::unordered_map<std::string, int> _indexes;
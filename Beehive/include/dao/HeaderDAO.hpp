@@ -26,6 +26,7 @@ SOFTWARE.
 
 #pragma once
 
+#include <dao/Storage.hpp>
 #include <entities/Header.hpp>
 
 #include <memory>
@@ -39,9 +40,10 @@ class HeaderDAO {
       public:
       HeaderDAO() {
       }
-      void save(Entities::Header &header, const std::string &context);
-      std::unique_ptr<Entities::Header> read(uint32_t idDataset, uint32_t node, uint32_t idNode, const std::string &context);
-      std::vector<Entities::Header> readFrom(uint32_t idDataset, uint32_t idHeader, const std::string &context);
+      void save(Entities::Header &header, const Storage::ContextHandle &context);
+      void save(Entities::Header &header, const Storage::ContextHandle &context, Storage::Batch &batch);
+      std::unique_ptr<Entities::Header> read(uint32_t idDataset, uint32_t node, uint32_t idNode, const Storage::ContextHandle &context);
+      std::vector<Entities::Header> readFrom(uint32_t idDataset, uint32_t idHeader, const Storage::ContextHandle &context);
 
    private:
       static std::string prefix;
@@ -0,0 +1,93 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Beehive {
+namespace Services {
+namespace DAO {
+
+// Storage keys whose byte order follows the order of their fields, so the
+// records of a dataset are contiguous and sorted by id. Integers are fixed
+// width big endian, UUIDs are their 16 raw bytes and strings are escaped
+// ("\0" as "\0\xff") and terminated by "\0\x01" so that a string sorts
+// before its extensions. The last field of a key may be appended unescaped
+// with putTail().
+class KeyCodec {
+   public:
+    KeyCodec(std::string_view prefix) : _key(prefix) {
+        _key.reserve(prefix.size() + 40);
+    }
+
+    KeyCodec &putUint16(uint16_t value);
+    KeyCodec &putUint32(uint32_t value);
+    KeyCodec &putUint64(uint64_t value);
+    KeyCodec &putUUID(std::string_view uuid);
+    KeyCodec &putString(std::string_view value);
+    KeyCodec &putTail(std::string_view value);
+
+    const std::string &key() const {
+        return _key;
+    }
+
+    // Smallest key greater than every key starting with this one.
+    std::string successor() const;
+
+    class Reader {
+       public:
+        Reader(std::string_view key, size_t prefix) : _key(key.substr(prefix)) {
+        }
+
+        uint16_t getUint16();
+        uint32_t getUint32();
+        uint64_t getUint64();
+        std::string getUUID();
+        std::string getString();
+
+        std::string_view tail() const {
+            return _key;
+        }
+
+       private:
+        uint64_t getBigEndian(size_t size);
+
+        std::string_view _key;
+    };
+
+   private:
+    void putBigEndian(uint64_t value, size_t size);
+
+    std::string _key;
+};
+
+} /* namespace DAO */
+} /* namespace Services */
+} /* namespace Beehive */
@@ -47,6 +47,9 @@ class NodeDAO {
       int remove(const std::string &uuidNode, const std::string &uuidUser, Storage::Transaction &transaction);
 
    private:
+      static std::string key(const std::string &uuidUser, const std::string &uuidNode);
+      static std::string legacyKey(const std::string &uuidUser, const std::string &uuidNode);
+
       static std::string prefix;
 };
 
@@ -0,0 +1,136 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <entities/Change.hpp>
+#include <entities/ChangeView.hpp>
+#include <entities/Dataset.hpp>
+#include <entities/Header.hpp>
+#include <entities/Member.hpp>
+#include <entities/Node.hpp>
+#include <entities/User.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Beehive {
+namespace Services {
+namespace DAO {
+
+// Binary form of the values stored by the DAOs. A record starts with the
+// format version and the record type, followed by fields tagged with their
+// number and wire type (varint or length delimited). Readers skip unknown
+// fields and keep defaults for missing ones, so fields can be added without
+// rewriting stored values. Values written as JSON documents by previous
+// versions start with '{' and are still decoded; they are rewritten in the
+// binary form the next time they are saved.
+class Record {
+public:
+  enum Type {
+    user = 1,
+    node = 2,
+    dataset = 3,
+    member = 4,
+    header = 5,
+    change = 6,
+    downloaded = 7
+  };
+
+  static std::string encode(const Entities::User &user);
+  static std::string encode(const Entities::Node &node);
+  static std::string encode(const Entities::Dataset &dataset);
+  static std::string encode(const Entities::Member &member);
+  static std::string encode(const Entities::Header &header);
+  static std::string encode(const Entities::ChangeView &change);
+
+  static void decode(std::string_view data, Entities::User &user);
+  static void decode(std::string_view data, Entities::Node &node);
+  static void decode(std::string_view data, Entities::Dataset &dataset);
+  static void decode(std::string_view data, Entities::Member &member);
+  static void decode(std::string_view data, Entities::Header &header);
+  static void decode(std::string_view data, Entities::Change &change);
+
+  static bool isJson(std::string_view data) {
+    return !data.empty() && data.front() == '{';
+  }
+
+  class Writer {
+  public:
+    Writer(Type type);
+
+    void put(uint32_t field, uint64_t value);
+    void put(uint32_t field, std::string_view value);
+
+    std::string &data() {
+      return _data;
+    }
+
+  private:
+    void putVarint(uint64_t value);
+
+    std::string _data;
+  };
+
+  class Reader {
+  public:
+    Reader(std::string_view data, Type type);
+
+    bool next();
+
+    uint32_t field() const {
+      return _field;
+    }
+
+    uint64_t integer() const {
+      return _integer;
+    }
+
+    std::string_view bytes() const {
+      return _bytes;
+    }
+
+    std::string string() const {
+      return std::string(_bytes);
+    }
+
+  private:
+    uint64_t getVarint();
+
+    std::string_view _data;
+    uint32_t _field;
+    uint64_t _integer;
+    std::string_view _bytes;
+  };
+
+  static const uint8_t Version = 1;
+};
+
+} /* namespace DAO */
+} /* namespace Services */
+} /* namespace Beehive */
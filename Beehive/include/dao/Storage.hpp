@@ -32,7 +32,14 @@ SOFTWARE.
 #include <rocksdb/slice.h>
 #include <rocksdb/utilities/transaction.h>
 #include <rocksdb/utilities/transaction_db.h>
+#include <rocksdb/write_batch.h>
+#include <dao/StorageProfile.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -72,21 +79,66 @@ class Storage {
     }
 
     class Transaction;
+    class Batch;
+    class Scan;
 
-    static void open();
+    // Counted reference to the column family of a context. Resolve it once per
+    // request with Storage::handle(); a handle stays usable while a concurrent
+    // deleteContext() drops the family, and the RocksDB handle is destroyed
+    // when the last reference is released.
+    class ContextHandle {
+       public:
+        ContextHandle() {
+        }
+
+        explicit operator bool() const {
+            return static_cast<bool>(_family);
+        }
+
+        const std::string &name() const {
+            return _family->GetName();
+        }
+
+       private:
+        friend class Storage;
+
+        ContextHandle(std::shared_ptr<rocksdb::ColumnFamilyHandle> family) : _family(std::move(family)) {
+        }
+
+        rocksdb::ColumnFamilyHandle *get() const {
+            return _family.get();
+        }
+
+        std::shared_ptr<rocksdb::ColumnFamilyHandle> _family;
+    };
+
+    static void open(const std::string &profile = "default");
     static void close();
 
     static void createContext(const std::string &uuid);
     static void deleteContext(const std::string &uuid);
     static std::vector<std::string> getContexts();
+    static ContextHandle handle(const std::string &context);
 
     static void putValue(const std::string &key, const std::string &value, const std::string &context);
+    static void putValue(const std::string &key, const std::string &value, const ContextHandle &context);
     static bool getValue(const std::string &key, std::string *value, const std::string &context);
+    static bool getValue(const std::string &key, std::string *value, const ContextHandle &context);
     static bool getValues(const std::string &key, std::vector<std::pair<std::string, std::string>> &values, const std::string &context);
+    static bool getValues(const std::string &key, std::vector<std::pair<std::string, std::string>> &values, const ContextHandle &context);
     static bool deleteValue(const std::string &key, const std::string &context);
+    static bool deleteValue(const std::string &key, const ContextHandle &context);
+    static Scan scan(const std::string &prefix, const std::string &context);
+    static Scan scan(const std::string &prefix, const ContextHandle &context);
 
     static Transaction begin();
 
+    // Writes the batch atomically and returns once it is durable on the WAL.
+    // Concurrent callers are grouped: the batches queued while the previous
+    // group was being written are copied into one batch and written with a
+    // single synced WAL write.
+    static void commit(Batch &batch);
+
     static const std::string DefaultContext;
 
     class Transaction {
@@ -102,8 +154,11 @@ class Storage {
         }
 
         void putValue(const std::string &key, const std::string &value, const std::string &context);
+        void putValue(const std::string &key, const std::string &value, const ContextHandle &context);
         bool getValue(const std::string &key, std::string *value, const std::string &context);
+        bool getValue(const std::string &key, std::string *value, const ContextHandle &context);
         bool deleteValue(const std::string &key, const std::string &context);
+        bool deleteValue(const std::string &key, const ContextHandle &context);
 
         void commit() {
             if (_transaction->Commit().ok())
@@ -124,10 +179,91 @@ class Storage {
         bool finished;
     };
 
+    class Batch {
+       public:
+        Batch() {
+        }
+
+        void putValue(const std::string &key, const std::string &value, const std::string &context);
+        void putValue(const std::string &key, const std::string &value, const ContextHandle &context);
+        void deleteValue(const std::string &key, const std::string &context);
+        void deleteValue(const std::string &key, const ContextHandle &context);
+
+        bool empty() const {
+            return _batch.Count() == 0;
+        }
+
+        // Marks the updates added so far; rollback() drops the ones added
+        // after the last mark.
+        void savePoint() {
+            _batch.SetSavePoint();
+        }
+
+        void rollback();
+
+       private:
+        friend class Storage;
+        rocksdb::ColumnFamilyHandle *family(uint32_t id) const;
+
+        rocksdb::WriteBatch _batch;
+        std::vector<ContextHandle> _contexts;
+    };
+
+    // Forward scan over the keys starting with a prefix, bounded with
+    // iterate_upper_bound and reading ahead. Blocks are pinned, so key() and
+    // value() stay valid for the lifetime of the scan.
+    //
+    //   for (Storage::Scan scan = Storage::scan(prefix, context); scan.valid(); scan.next())
+    class Scan {
+       public:
+        Scan(const Scan&) = delete;
+        Scan &operator=(const Scan&) = delete;
+
+        bool valid() const {
+            return _iterator && _iterator->Valid();
+        }
+
+        void next();
+
+        // Positions the scan at the first key at or after the given one.
+        void seek(const std::string &key);
+
+        rocksdb::Slice key() const {
+            return _iterator->key();
+        }
+
+        rocksdb::Slice value() const {
+            return _iterator->value();
+        }
+
+       private:
+        friend class Storage;
+
+        Scan(const ContextHandle &context, const std::string &prefix);
+
+        void check();
+
+        ContextHandle _context;
+        std::string _upperBound;
+        rocksdb::Slice _upperBoundSlice;
+        std::unique_ptr<rocksdb::Iterator> _iterator;
+    };
+
    private:
+    struct Writer;
+    class Appender;
+    typedef std::unordered_map<std::string, std::shared_ptr<rocksdb::ColumnFamilyHandle>> HandleTable;
+
+    static std::shared_ptr<rocksdb::ColumnFamilyHandle> family(rocksdb::ColumnFamilyHandle *handle);
+
     static rocksdb::TransactionDB* db;
-    static std::vector<rocksdb::ColumnFamilyHandle*> handles;
-    static std::unordered_map<std::string, rocksdb::ColumnFamilyHandle*> handlesMap;
+    static StorageProfile profile;
+    static std::atomic<std::shared_ptr<const HandleTable>> handles;
+    static std::mutex handlesMutex;
+    static std::mutex commitMutex;
+    static std::condition_variable commitCondition;
+    static std::deque<Writer*> commitQueue;
+    static bool committing;
 };
 
 } /* namespace DAO */
@@ -0,0 +1,116 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <rocksdb/cache.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/options.h>
+#include <rocksdb/slice_transform.h>
+#include <rocksdb/table.h>
+
+#include <json/json.hpp>
+
+#include <memory>
+#include <string>
+
+namespace Beehive {
+namespace Services {
+namespace DAO {
+
+// RocksDB tuning applied by Storage. Keys are grouped in families by the
+// segment before their first '.', so the prefix extractor and the memtable
+// prefix bloom follow the DAO prefixes ("U.", "N.", "H.", "Schema.", ...).
+// The system settings apply to the default column family and the contexts
+// settings to every context column family; the block cache is shared.
+struct StorageProfile {
+    struct Family {
+        std::string compression;
+        std::string bottommostCompression;
+        std::string compactionStyle;
+        size_t writeBufferSize;
+        int maxWriteBufferNumber;
+        bool dynamicLevelBytes;
+        bool optimizeFiltersForHits;
+    };
+
+    std::string name;
+    size_t blockCacheSize;
+    size_t blockSize;
+    double bloomBitsPerKey;
+    double memtablePrefixBloomRatio;
+    bool cacheIndexAndFilterBlocks;
+    int backgroundJobs;
+    Family system;
+    Family contexts;
+
+    // Built in profiles are "default", "write-heavy", "read-heavy" and
+    // "small"; any other value is read as the path of a JSON profile.
+    static StorageProfile load(const std::string &profile);
+
+    rocksdb::DBOptions dbOptions() const;
+    rocksdb::ColumnFamilyOptions familyOptions(const std::string &family) const;
+
+   private:
+    std::shared_ptr<rocksdb::TableFactory> _tableFactory;
+    std::shared_ptr<const rocksdb::SliceTransform> _prefixExtractor;
+};
+
+} /* namespace DAO */
+} /* namespace Services */
+} /* namespace Beehive */
+
+namespace nlohmann {
+using Beehive::Services::DAO::StorageProfile;
+
+void from_json(const json &j, StorageProfile::Family &x);
+void from_json(const json &j, StorageProfile &x);
+
+inline void from_json(const json &j, StorageProfile::Family &x) {
+    x.compression = j.value("compression", x.compression);
+    x.bottommostCompression = j.value("bottommostCompression", x.bottommostCompression);
+    x.compactionStyle = j.value("compactionStyle", x.compactionStyle);
+    x.writeBufferSize = j.value("writeBufferSize", x.writeBufferSize);
+    x.maxWriteBufferNumber = j.value("maxWriteBufferNumber", x.maxWriteBufferNumber);
+    x.dynamicLevelBytes = j.value("dynamicLevelBytes", x.dynamicLevelBytes);
+    x.optimizeFiltersForHits = j.value("optimizeFiltersForHits", x.optimizeFiltersForHits);
+}
+
+inline void from_json(const json &j, StorageProfile &x) {
+    x.name = j.value("name", x.name);
+    x.blockCacheSize = j.value("blockCacheSize", x.blockCacheSize);
+    x.blockSize = j.value("blockSize", x.blockSize);
+    x.bloomBitsPerKey = j.value("bloomBitsPerKey", x.bloomBitsPerKey);
+    x.memtablePrefixBloomRatio = j.value("memtablePrefixBloomRatio", x.memtablePrefixBloomRatio);
+    x.cacheIndexAndFilterBlocks = j.value("cacheIndexAndFilterBlocks", x.cacheIndexAndFilterBlocks);
+    x.backgroundJobs = j.value("backgroundJobs", x.backgroundJobs);
+    if (j.find("system") != j.end())
+        j.at("system").get_to(x.system);
+    if (j.find("contexts") != j.end())
+        j.at("contexts").get_to(x.contexts);
+}
+} /* namespace nlohmann */
@@ -36,7 +36,7 @@ namespace Entities {
 
 class Dataset {
    public:
-    uint32_t id() {
+    uint32_t id() const {
         return _id;
     }
 
@@ -52,7 +52,7 @@ class Dataset {
         _uuid = uuid;
     }
 
-    uint32_t idHeader() {
+    uint32_t idHeader() const {
         return _idHeader;
     }
 
@@ -60,7 +60,7 @@ class Dataset {
         _idHeader = idHeader;
     }
 
-    std::string owner() {
+    std::string owner() const {
         return _owner;
     }
 
@@ -68,7 +68,7 @@ class Dataset {
         _owner = owner;
     }
 
-    uint8_t status() {
+    uint8_t status() const {
         return _status;
     }
 
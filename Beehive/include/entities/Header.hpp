@@ -27,7 +27,8 @@ SOFTWARE.
 
 #pragma once
 
-#include <entities/Change.hpp>
+#include <entities/ChangeView.hpp>
+#include <memory/Arena.hpp>
 
 #include <string>
 #include <vector>
@@ -38,7 +39,10 @@ namespace Entities {
 
 class Header {
    public:
-    uint32_t idDataset() {
+    Header() : _arena(nullptr) {
+    }
+
+    uint32_t idDataset() const {
         return _idDataset;
     }
 
@@ -46,7 +50,7 @@ class Header {
         _idDataset = idDataset;
     }
 
-    uint32_t idHeader() {
+    uint32_t idHeader() const {
         return _idHeader;
     }
 
@@ -54,7 +58,7 @@ class Header {
         _idHeader = idHeader;
     }
 
-    std::string transactionName() {
+    std::string transactionName() const {
         return _transactionName;
     }
 
@@ -62,7 +66,7 @@ class Header {
         _transactionName = transactionName;
     }
 
-    std::string transactionUUID() {
+    std::string transactionUUID() const {
         return _transactionUUID;
     }
 
@@ -70,7 +74,7 @@ class Header {
         _transactionUUID = transactionUUID;
     }
 
-    uint32_t node() {
+    uint32_t node() const {
         return _node;
     }
 
@@ -78,7 +82,7 @@ class Header {
         _node = node;
     }
 
-    uint32_t idNode() {
+    uint32_t idNode() const {
         return _idNode;
     }
 
@@ -86,7 +90,7 @@ class Header {
         _idNode = idNode;
     }
 
-    uint8_t status() {
+    uint8_t status() const {
         return _status;
     }
 
@@ -94,7 +98,7 @@ class Header {
         _status = status;
     }
 
-    uint32_t version() {
+    uint32_t version() const {
         return _version;
     }
 
@@ -102,14 +106,22 @@ class Header {
         _version = version;
     }
 
-    std::vector<Change>& changes() {
+    std::vector<ChangeView>& changes() {
         return _changes;
     }
 
-    void changes(const std::vector<Change> changes) {
+    void changes(const std::vector<ChangeView> changes) {
         _changes = std::move(changes);
     }
 
+    Memory::Arena *arena() {
+        return _arena;
+    }
+
+    void arena(Memory::Arena *arena) {
+        _arena = arena;
+    }
+
    private:
     uint32_t _idDataset;
     uint32_t _idHeader;
@@ -119,7 +131,8 @@ class Header {
     uint32_t _idNode;
     uint8_t _status;
     uint32_t _version;
-    std::vector<Change> _changes;
+    std::vector<ChangeView> _changes;
+    Memory::Arena *_arena;
 };
 
 } /* namespace Entities */
@@ -35,7 +35,7 @@ namespace Entities {
 
 class Member {
    public:
-    uint32_t idDataset() {
+    uint32_t idDataset() const {
         return _idDataset;
     }
 
@@ -43,7 +43,7 @@ class Member {
         _idDataset = idDataset;
     }
 
-    std::string idUser() {
+    std::string idUser() const {
         return _idUser;
     }
 
@@ -51,7 +51,7 @@ class Member {
         _idUser = idUser;
     }
 
-    std::string role() {
+    std::string role() const {
         return _role;
     }
 
@@ -59,7 +59,7 @@ class Member {
         _role = role;
     }
 
-    std::string name() {
+    std::string name() const {
         return _name;
     }
 
@@ -67,7 +67,7 @@ class Member {
         _name = name;
     }
 
-    std::string email() {
+    std::string email() const {
         return _email;
     }
 
@@ -75,7 +75,7 @@ class Member {
         _email = email;
     }
 
-    uint8_t status() {
+    uint8_t status() const {
         return _status;
     }
 
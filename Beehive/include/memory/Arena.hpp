@@ -0,0 +1,83 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+
+namespace Beehive {
+namespace Services {
+namespace Memory {
+
+// Bump allocator for data that lives as long as a single message. Memory is
+// only given back when the arena is reset or destroyed.
+class Arena {
+   public:
+    Arena() : _resource() {
+    }
+
+    Arena(size_t initialSize) : _initial(new char[initialSize]), _resource(_initial.get(), initialSize) {
+    }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    char *allocate(size_t size) {
+        return static_cast<char *>(_resource.allocate(size ? size : 1, 1));
+    }
+
+    std::string_view store(const char *data, size_t size) {
+        if (size == 0)
+            return std::string_view();
+        char *ptr = allocate(size);
+        memcpy(ptr, data, size);
+        return std::string_view(ptr, size);
+    }
+
+    std::string_view store(std::string_view data) {
+        return store(data.data(), data.size());
+    }
+
+    std::pmr::memory_resource *resource() {
+        return &_resource;
+    }
+
+    void reset() {
+        _resource.release();
+    }
+
+   private:
+    std::unique_ptr<char[]> _initial;
+    std::pmr::monotonic_buffer_resource _resource;
+};
+
+} /* namespace Memory */
+} /* namespace Services */
+} /* namespace Beehive */
@@ -0,0 +1,60 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <config/Context.hpp>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Beehive {
+namespace Services {
+
+// Process wide cache of parsed and compiled contexts keyed by uuid and version.
+// Readers only load the current snapshot; misses and invalidations build a new
+// snapshot under the mutex and publish it. Published contexts are never
+// modified, a schema change replaces them.
+class ContextRegistry {
+   public:
+    static std::shared_ptr<Config::Context> get(const std::string &uuid, uint32_t version);
+    static void invalidate(const std::string &uuid);
+
+   private:
+    typedef std::unordered_map<std::string, std::map<uint32_t, std::shared_ptr<Config::Context>>> Snapshot;
+
+    static void compile(Config::Context &context);
+
+    static std::atomic<std::shared_ptr<const Snapshot>> _snapshot;
+    static std::mutex _mutex;
+};
+
+} /* namespace Services */
+} /* namespace Beehive */
@@ -29,10 +29,16 @@ SOFTWARE.
 
 #include <entities/Node.hpp>
 #include <services/DatasetService.hpp>
+#include <services/NotificationHub.hpp>
 #include <services/StorageService.hpp>
 #include <services/UserService.hpp>
+#include <tcp/EventLoop.hpp>
+#include <tcp/Message.hpp>
 #include <tcp/TCPHandler.hpp>
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <string>
 
 namespace Beehive {
@@ -49,8 +55,19 @@ class InboundTCP {
     void start();
     void finish();
 
+    static void maxConnections(uint32_t maxConnections) {
+        _maxConnections = maxConnections;
+    }
+
+    static void workers(uint32_t workers) {
+        _workers = workers;
+    }
+
    private:
-   int _tcpSocket;
+    int _tcpSocket;
+    TCP::EventLoop _eventLoop;
+    static uint32_t _maxConnections;
+    static uint32_t _workers;
 };
 
 class BinSyncHandlerIntance : public TCP::TCPHandler {
@@ -60,11 +77,18 @@ class BinSyncHandlerIntance : public TCP::TCPHandler {
     }
 
     virtual ~BinSyncHandlerIntance() {
+        if (_subscription)
+            NotificationHub::unsubscribe(_subscription);
         delete _buffer;
     }
-    void run(void);
+    bool resume() override;
 
    private:
+    bool handshake(uint8_t option);
+    bool negotiate(uint8_t option, uint8_t value);
+    bool operation(uint8_t option);
+    void fail(uint8_t code);
+    bool recoverable() const;
     void deleteDataset(Services::Entities::Node &node);
     void pushDataset(Services::Entities::Node &node);
     void popDataset(Services::Entities::Node &node);
@@ -74,6 +98,34 @@ class BinSyncHandlerIntance : public TCP::TCPHandler {
     void updateMember(Services::Entities::Node &node);
     void deleteMember(Services::Entities::Node &node);
     void fullSync(Services::Entities::Node &node);
+    void subscribe(Services::Entities::Node &node);
+    void deliver();
+
+    typedef TCP::Message<TCP::U16String, TCP::U8String, TCP::U8String, TCP::U8String, TCP::U32> TokenSignIn;
+    typedef TCP::Message<TCP::U8String, TCP::U8String, TCP::U8String, TCP::U8String, TCP::U8String, TCP::U32> PasswordSignIn;
+    typedef TCP::Message<TCP::U8String, TCP::U8String, TCP::U8String, TCP::U8String, TCP::U8String, TCP::U8String, TCP::U32> SignUp;
+    typedef TCP::Message<TCP::U16String, TCP::U8String> TokenSignOff;
+    typedef TCP::Message<TCP::U8String, TCP::U8String, TCP::U8String> PasswordSignOff;
+    typedef TCP::Message<TCP::U8, TCP::U8> Negotiation;
+    typedef TCP::Message<TCP::Fixed<28>, TCP::U32> Reconnection;
+    typedef TCP::Message<TCP::UUID, TCP::Fixed<64>> Session;
+    typedef TCP::Message<TCP::UUID> DatasetRequest;
+    typedef TCP::Message<TCP::UUID, TCP::U8String, TCP::U64, TCP::U32> PushRequest;
+    typedef TCP::Message<TCP::UUID> PushReply;
+    typedef TCP::Message<TCP::UUID, TCP::UUID, TCP::U8String> PopRequest;
+    typedef TCP::Message<TCP::UUID, TCP::UUID> PullRequest;
+    typedef TCP::Message<TCP::UUID, TCP::U8String, TCP::U8String, TCP::U8String> PutRequest;
+    typedef TCP::Message<TCP::UUID, TCP::U64, TCP::U8String, TCP::U8String> MemberUpdate;
+    typedef TCP::Message<TCP::UUID, TCP::U64> MemberRequest;
+    typedef TCP::Message<TCP::U8> SubscriptionRequest;
+    typedef TCP::Message<TCP::UUID, TCP::U32> Notification;
+
+    // Operation of the frames that notify a new header of a data set.
+    static const uint8_t NotificationOperation = 'a';
+
+    // Subscribed sessions wait for notifications longer than the event loop
+    // keeps other idle connections.
+    static constexpr std::chrono::seconds SubscriptionTimeout = std::chrono::minutes(30);
 
     enum Codes {
         success = 0,                   //
@@ -85,14 +137,23 @@ class BinSyncHandlerIntance : public TCP::TCPHandler {
         userNotFound = 100,            //
         notEnoughRights = 110,         //
         invalidSchema = 120,           //
+        notSupported = 130,            //
         internalError = 255            //
     };
 
+    enum Options {
+        checksumAlgorithm = 1,  //
+        messageFraming = 2,     //
+        payloadCompression = 3  //
+    };
+
     //std::shared_ptr<Services::DAO::SQL::Connection> _connection;
     //Services::UserService _userService;
     //Services::DatasetService _datasetService;
     //Services::StorageService _storageService;
     uint8_t *_buffer;
+    std::unique_ptr<Services::Entities::Node> _node;
+    std::shared_ptr<NotificationHub::Subscription> _subscription;
 };
 
 } /* namespace Services */
@@ -0,0 +1,81 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Beehive {
+namespace Services {
+
+// Process wide fan-out of committed headers to the sessions subscribed to a
+// data set. Publishing only records the last header of the data set in each
+// subscription and wakes its session, which sends the notifications from its
+// own worker, so a slow client never holds up a commit.
+class NotificationHub {
+   public:
+    class Subscription {
+       public:
+        Subscription(std::function<void()> wake) : _wake(std::move(wake)) {
+        }
+
+        // Takes the pending notifications, the last header of every data set
+        // that advanced since the previous call.
+        std::unordered_map<std::string, uint32_t> take();
+
+       private:
+        friend class NotificationHub;
+
+        void post(const std::string &uuidDataset, uint32_t idHeader);
+
+        std::function<void()> _wake;
+        std::mutex _mutex;
+        std::unordered_map<std::string, uint32_t> _pending;
+        std::vector<std::string> _keys;
+    };
+
+    static void subscribe(const std::string &context, const std::string &uuidDataset, const std::shared_ptr<Subscription> &subscription);
+    static void unsubscribe(const std::shared_ptr<Subscription> &subscription);
+    static void publish(const std::string &context, const std::string &uuidDataset, uint32_t idHeader);
+
+   private:
+    static std::string key(const std::string &context, const std::string &uuidDataset) {
+        return context + "/" + uuidDataset;
+    }
+
+    static std::mutex _mutex;
+    static std::unordered_map<std::string, std::vector<std::weak_ptr<Subscription>>> _subscriptions;
+};
+
+} /* namespace Services */
+} /* namespace Beehive */
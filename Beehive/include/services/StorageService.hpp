@@ -37,6 +37,7 @@ SOFTWARE.
 #include <dao/MemberDAO.hpp>
 #include <dao/NodeDAO.hpp>
 #include <entities/Change.hpp>
+#include <entities/ChangeView.hpp>
 #include <entities/Dataset.hpp>
 #include <entities/Node.hpp>
 #include <entities/User.hpp>
@@ -55,7 +56,7 @@ namespace Services {
 
 class StorageService {
    public:
-    StorageService() : _context(nullptr) {
+    StorageService() {
     }
 
     virtual ~StorageService() {
@@ -112,7 +113,7 @@ class StorageService {
     };
 
     ValidationCodes checkHeaderAndTransform(Entities::Node &node, Entities::Header &header);
-    ValidationCodes applyChange(Entities::Node &node, Entities::Header &header, Entities::Change &change);
+    ValidationCodes applyChange(Entities::Node &node, Entities::Header &header, Entities::ChangeView &change, const DAO::Storage::ContextHandle &context, DAO::Storage::Batch &batch);
 
     bool isMember(Entities::Node &node, uint32_t idDataset);
     EntityReader readEntityData(Entities::Node &node, uint32_t idDataset, Config::Entity &entity, const std::unordered_map<std::string, std::unordered_set<int>> &entitiesByNode);
@@ -124,7 +125,7 @@ class StorageService {
     std::unordered_map<std::string, std::unordered_set<int>> entitiesByNode(Entities::Node &node, uint32_t idDataset);
     std::unordered_map<std::string, Config::Entity, Utils::IHasher, Utils::IEqualsComparator> &entities(uint16_t clientVersion);
 
-    void context(Config::Context *context);
+    void context(std::shared_ptr<Config::Context> context);
 
    private:
     DAO::DatasetDAO _datasetDAO;
@@ -135,7 +136,7 @@ class StorageService {
     DAO::NodeDAO _nodeDAO;
     DAO::EntityDAO _entityDAO;
     Utils::TransactionsManager _transactionsManager;
-    Config::Context *_context;
+    std::shared_ptr<Config::Context> _context;
 };
 
 } /* namespace Services */
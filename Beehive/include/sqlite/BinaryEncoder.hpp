@@ -30,36 +30,60 @@ SOFTWARE.
 #include <sqlite/Types.hpp>
 #include <sqlite/BinaryDecoder.hpp>
 #include <sqlite/TextDecoder.hpp>
+#include <memory/Arena.hpp>
 
 #include <cstring>
+#include <memory_resource>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 namespace Beehive {
 namespace Services {
 namespace SqLite {
 
+// Attributes are appended to a single buffer as they are added and indexed by
+// id, so encodedData() emits them in id order with a single copy. Adding the
+// same attribute twice keeps the last value.
 class BinaryEncoder {
 public:
-  BinaryEncoder() {
+  BinaryEncoder(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) :
+      _buffer(resource), _fragments(resource), _unused(0) {
+    _buffer.reserve(InitialSize);
+    _fragments.reserve(InitialFragments);
   }
   virtual ~BinaryEncoder() {
   }
 
   void addInteger(int attribute, uint64_t data);
   void addReal(int attribute, double value);
-  void addText(int attribute, std::string data);
-  void addBlob(int attribute, std::string data);
+  void addText(int attribute, std::string_view data);
+  void addBlob(int attribute, std::string_view data);
   void addNull(int attribute);
-  void addUUID(int attribute, std::string data);
+  void addUUID(int attribute, std::string_view data);
   void addValue(BinaryDecoder::Value &value);
   void addValue(TextDecoder::Value &value);
   std::string encodedData();
+  std::string_view encodedData(Memory::Arena &arena);
 private:
+  static constexpr size_t InitialSize = 256;
+  static constexpr size_t InitialFragments = 16;
+
+  struct Fragment {
+    int attribute;
+    uint32_t offset;
+    uint32_t size;
+  };
+
   int varintLen(uint64_t v);
   int putVarint(unsigned char *p, uint64_t v);
+  uint8_t* append(int attribute, size_t size);
+  size_t encodedSize();
+  void encode(char *buffer);
 
-  std::unordered_map<int, std::string> _data;
+  std::pmr::vector<char> _buffer;
+  std::pmr::vector<Fragment> _fragments;
+  size_t _unused;
 };
 
 } /* namespace SqLite */
@@ -0,0 +1,73 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <string/ICaseMap.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Beehive {
+namespace Services {
+namespace SqLite {
+
+// Case insensitive column name to id table compiled once per entity. Names are
+// placed with hash and displace, so a lookup hashes the name twice, probes a
+// single slot and never allocates.
+class ColumnCodec {
+public:
+  ColumnCodec() :
+      _mask(0) {
+  }
+
+  ColumnCodec(const std::unordered_map<std::string, int, Utils::IHasher, Utils::IEqualsComparator> &columns);
+
+  virtual ~ColumnCodec() {
+  }
+
+  int find(std::string_view name) const;
+
+private:
+  struct Slot {
+    std::string name;
+    int id;
+  };
+
+  static uint32_t hash(std::string_view name, uint32_t seed);
+  static bool equals(std::string_view folded, std::string_view name);
+
+  std::vector<uint32_t> _displacements;
+  std::vector<Slot> _slots;
+  uint32_t _mask;
+};
+
+} /* namespace SqLite */
+} /* namespace Services */
+} /* namespace Beehive */
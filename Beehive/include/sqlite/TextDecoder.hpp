@@ -28,11 +28,12 @@ SOFTWARE.
 #pragma once
 
 #include <sqlite/Types.hpp>
-#include <string/ICaseMap.hpp>
+#include <sqlite/ColumnCodec.hpp>
 
 #include <algorithm>
+#include <cstring>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
 namespace Beehive {
 namespace Services {
@@ -40,8 +41,8 @@ namespace SqLite {
 
 class TextDecoder {
 public:
-  TextDecoder(const char *data, size_t size, const std::unordered_map<std::string, int, Utils::IHasher, Utils::IEqualsComparator> &mapping, std::string entity) :
-      _data(data), _size(size), _mapping(mapping), _entity(entity) {
+  TextDecoder(const char *data, size_t size, const ColumnCodec &codec, std::string_view entity) :
+      _data(data), _size(size), _codec(codec), _entity(entity) {
   }
 
   virtual ~TextDecoder() {
@@ -49,19 +50,21 @@ public:
 
   class Value {
   public:
-    Value(const char *data, size_t size, const std::unordered_map<std::string, int, Utils::IHasher, Utils::IEqualsComparator> &mapping, std::string &entity) :
-        _current(data), _data(data), _end(data + size), _mapping(mapping), _entity(entity) {
+    Value(const char *data, size_t size, const ColumnCodec &codec, std::string_view entity) :
+        _data(data), _end(data + size), _codec(codec), _entity(entity) {
+      if (_data < _end)
+        _current = std::string_view(_data, strnlen(_data, _end - _data));
       _currentId = goForward(false);
     }
     virtual ~Value() {
     }
     uint16_t id();
-    std::string column();
+    std::string_view column();
     int type();
     long integerValue();
     double realValue();
-    std::string textValue();
-    std::string blobValue();
+    std::string_view textValue();
+    std::string_view blobValue();
     Value& operator++();
     Value operator++(int);
     bool operator==(const Value &rhs) const;
@@ -69,20 +72,20 @@ public:
   private:
     uint16_t goForward(bool skip);
     uint8_t variantLenght(uint32_t &value, const char *data);
-    std::string _current;
+    std::string_view _current;
     const char *_data;
     const char *_end;
-    const std::unordered_map<std::string, int, Utils::IHasher, Utils::IEqualsComparator> &_mapping;
+    const ColumnCodec &_codec;
     uint16_t _currentId;
-    std::string _entity;
+    std::string_view _entity;
     uint32_t _beehive;
   };
 
   class iterator: public std::iterator<std::input_iterator_tag, Value> {
     Value _current;
   public:
-    iterator(const char *data, size_t size, const std::unordered_map<std::string, int, Utils::IHasher, Utils::IEqualsComparator> &mapping, std::string &entity) :
-        _current(data, size, mapping, entity) {
+    iterator(const char *data, size_t size, const ColumnCodec &codec, std::string_view entity) :
+        _current(data, size, codec, entity) {
     }
     iterator(const iterator &mit) :
         _current(mit._current) {
@@ -100,8 +103,8 @@ public:
 private:
   const char *_data;
   size_t _size;
-  const std::unordered_map<std::string, int, Utils::IHasher, Utils::IEqualsComparator> &_mapping;
-  std::string _entity;
+  const ColumnCodec &_codec;
+  std::string_view _entity;
 };
 
 } /* namespace SqLite */
@@ -34,6 +34,7 @@ SOFTWARE.
 
 #include <cstring>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <map>
 
@@ -53,8 +54,8 @@ public:
 
   void addInteger(int attribute, uint64_t data);
   void addReal(int attribute, double value);
-  void addText(int attribute, std::string data);
-  void addBlob(int attribute, std::string data);
+  void addText(int attribute, std::string_view data);
+  void addBlob(int attribute, std::string_view data);
   void addNull(int attribute);
   void addValue(BinaryDecoder::Value &value);
   void addValue(TextDecoder::Value &value);
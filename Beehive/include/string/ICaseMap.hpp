@@ -28,6 +28,7 @@ SOFTWARE.
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace Beehive {
 namespace Services {
@@ -35,17 +36,20 @@ namespace Utils {
 
 class ILessComparator {
 public:
-  bool operator()(const std::string &a, const std::string &b) const;
+  using is_transparent = void;
+  bool operator()(std::string_view a, std::string_view b) const;
 };
 
 class IEqualsComparator {
 public:
-  bool operator()(const std::string &a, const std::string &b) const;
+  using is_transparent = void;
+  bool operator()(std::string_view a, std::string_view b) const;
 };
 
 class IHasher {
 public:
-  size_t operator()(std::string const &key) const;
+  using is_transparent = void;
+  size_t operator()(std::string_view key) const;
 };
 
 } /* namespace Utils */
@@ -24,47 +24,27 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
-
 #pragma once
 
-#include <condition_variable>
-#include <mutex>
-#include <chrono>
+#include <cstddef>
+#include <cstdint>
 
 namespace Beehive {
 namespace Services {
 namespace TCP {
 
-class SocketWatcher {
-public:
-  SocketWatcher();
-
-  enum Wait {
-    Short, Long
-  };
-
-  class Watcher {
-    friend class SocketWatcher;
-  public:
-    Watcher(int clientSocket, Wait wait = Long);
-    ~Watcher();
-  private:
-    int _clientSocket;
-    Watcher *_next;
-    Watcher *_prev;
-    std::chrono::system_clock::time_point _expires;
-  };
-
-  void put(Watcher *client);
-  void drop(Watcher *client);
-
-private:
-  Watcher *_head;
-  Watcher *_tail;
-  std::condition_variable _wait;
-  std::mutex _mutex;
+// Checksums used by the synchronization protocol. Both functions can be
+// chained over consecutive buffers starting with a crc of 0.
+//
+// CRC-16/ARC is the protocol default, CRC32C can be negotiated by clients and
+// uses the SSE4.2 crc32 instruction when the processor provides it.
+enum class Checksum : uint8_t {
+  CRC16 = 0, CRC32C = 1
 };
 
+uint16_t crc16(uint16_t crc, const void *data, size_t size);
+uint32_t crc32c(uint32_t crc, const void *data, size_t size);
+
 } /* namespace TCP */
 } /* namespace Services */
 } /* namespace Beehive */
@@ -0,0 +1,115 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <zstd.h>
+
+namespace Beehive {
+namespace Services {
+namespace TCP {
+
+// Compression of V2 frame payloads negotiated by a client. LZ4 favours
+// latency, Zstandard the ratio, and the latter uses the dictionary of the
+// context once the node is known.
+enum class Compression : uint8_t {
+  None = 0, LZ4 = 1, ZSTD = 2
+};
+
+// Zstandard dictionary trained offline (zstd --train) over representative
+// rows of a context and loaded from <directory>/<context>.dict. Clients use
+// the same file, the frames carry its id.
+class Dictionary {
+public:
+  Dictionary(const Dictionary&) = delete;
+  Dictionary& operator=(const Dictionary&) = delete;
+  ~Dictionary();
+
+  static void directory(const std::string &directory);
+
+  // The dictionary of a context, nullptr when it has none.
+  static std::shared_ptr<const Dictionary> get(const std::string &context);
+
+  unsigned id() const {
+    return _id;
+  }
+
+private:
+  friend class Compressor;
+
+  Dictionary(const std::string &data);
+
+  ZSTD_CDict *_compress;
+  ZSTD_DDict *_decompress;
+  unsigned _id;
+
+  static std::string _directory;
+  static std::mutex _mutex;
+  static std::unordered_map<std::string, std::shared_ptr<const Dictionary>> _dictionaries;
+};
+
+// Compression state of a connection. The Zstandard contexts are created on
+// first use and reused for every frame.
+class Compressor {
+public:
+  Compressor() :
+      _compress(nullptr), _decompress(nullptr) {
+  }
+  Compressor(const Compressor&) = delete;
+  Compressor& operator=(const Compressor&) = delete;
+  ~Compressor();
+
+  void dictionary(std::shared_ptr<const Dictionary> dictionary) {
+    _dictionary = std::move(dictionary);
+  }
+
+  // Appends the compressed data to output.
+  void compress(Compression algorithm, const uint8_t *data, size_t size, std::vector<uint8_t> &output);
+  // Appends the size bytes the compressed data expands to to output.
+  void decompress(Compression algorithm, const uint8_t *data, size_t compressedSize, size_t size, std::vector<uint8_t> &output);
+
+private:
+  friend class Dictionary;
+
+  static const int Level = 3;
+
+  ZSTD_CCtx *_compress;
+  ZSTD_DCtx *_decompress;
+  std::shared_ptr<const Dictionary> _dictionary;
+};
+
+} /* namespace TCP */
+} /* namespace Services */
+} /* namespace Beehive */
@@ -0,0 +1,127 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <tcp/TCPHandler.hpp>
+#include <tcp/TimerWheel.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace Beehive {
+namespace Services {
+namespace TCP {
+
+// Edge triggered epoll reactor. A single thread accepts connections and waits
+// for input on all of them; when a connection becomes readable it is handed to
+// a fixed pool of workers that call TCPHandler::resume(). Connections are armed
+// with EPOLLONESHOT so only one worker drives a handler at any time.
+//
+// Handlers return to the loop instead of waiting for the rest of a request
+// (see TCPHandler::frameReady() and TCPHandler::mark()), so a slow client
+// does not hold a worker. While part of a request has arrived the connection
+// is closed when the request deadline (MessageTimeout) passes.
+//
+// Idle connections are tracked by a timer wheel owned by the reactor thread.
+// Workers give connections back through a lock-free stack, also the ones
+// whose handler finished, so the wheel and the epoll registrations are only
+// modified, and connections only deleted, from the reactor thread.
+//
+// A handler can also be woken from any thread (TCPHandler::wake()) to send
+// data without waiting for input. An idle connection is removed from epoll
+// and handed to a worker, so no event can reach the reactor while a worker
+// owns it; a busy one is resumed again by the worker or by the reactor when
+// it is given back.
+class EventLoop {
+public:
+  typedef std::function<TCPHandler* (int socket)> Factory;
+
+  EventLoop();
+  virtual ~EventLoop();
+
+  void run(int listenSocket, size_t maxConnections, size_t workers, Factory factory);
+  void finish();
+
+private:
+  struct Connection: public TimerWheel::Timer {
+    Connection(int socket, TCPHandler *handler) :
+        socket(socket), handler(handler), returned(nullptr), closed(false), idle(false), registered(false), woken(false) {
+    }
+
+    int socket;
+    std::unique_ptr<TCPHandler> handler;
+    Connection *returned;
+    // Given back to be released, set by the worker before pushing it.
+    bool closed;
+    // Waiting in epoll, only used by the reactor thread.
+    bool idle;
+    // Added to epoll, only used by the reactor thread.
+    bool registered;
+    // A wake is pending, guarded by _mutex.
+    bool woken;
+  };
+
+  static constexpr std::chrono::seconds MessageTimeout = std::chrono::seconds(60);
+
+  void accept();
+  void dispatch(Connection *connection);
+  void resubscribe();
+  void awaken();
+  void expire();
+  void work();
+  void wake(Connection *connection);
+  bool claim(Connection *connection);
+  void release(Connection *connection);
+
+  int _epoll;
+  int _wakeup;
+  int _listenSocket;
+  size_t _maxConnections;
+  Factory _factory;
+  std::atomic<bool> _running;
+  std::atomic<Connection*> _returned;
+  TimerWheel _timers;
+  std::deque<Connection*> _ready;
+  std::unordered_set<Connection*> _connections;
+  std::vector<Connection*> _woken;
+  std::mutex _mutex;
+  std::condition_variable _wait;
+  std::vector<std::thread> _workers;
+};
+
+} /* namespace TCP */
+} /* namespace Services */
+} /* namespace Beehive */
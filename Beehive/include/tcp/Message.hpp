@@ -0,0 +1,185 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include <tcp/TCPException.hpp>
+#include <tcp/TCPHandler.hpp>
+
+namespace Beehive {
+namespace Services {
+namespace TCP {
+
+// Fields of the protocol messages. Integers are sent big endian and strings
+// are prefixed with their length. Each field knows how to receive itself into
+// the message block of a TCPHandler, how to read its value from there and
+// how to append a value to an outgoing message.
+template<typename Integer>
+struct Number {
+  typedef Integer Value;
+
+  static size_t receive(TCPHandler &handler, size_t &size) {
+    size = sizeof(Integer);
+    return handler.take(sizeof(Integer));
+  }
+
+  static Value value(const uint8_t *data, size_t) {
+    Integer value = 0;
+    for (size_t i = 0; i < sizeof(Integer); ++i)
+      value = (Integer) ((value << 8) | data[i]);
+    return value;
+  }
+
+  static size_t size(Value) {
+    return sizeof(Integer);
+  }
+
+  static void append(std::string &buffer, Value value) {
+    for (size_t i = sizeof(Integer); 0 < i; --i)
+      buffer.push_back((char) (value >> ((i - 1) * 8)));
+  }
+};
+
+typedef Number<uint8_t> U8;
+typedef Number<uint16_t> U16;
+typedef Number<uint32_t> U32;
+typedef Number<uint64_t> U64;
+
+template<typename Length>
+struct String {
+  typedef std::string_view Value;
+
+  static size_t receive(TCPHandler &handler, size_t &size) {
+    size_t offset = handler.take(sizeof(Length));
+    size = Number<Length>::value(handler.message() + offset, sizeof(Length));
+    return handler.take(size);
+  }
+
+  static Value value(const uint8_t *data, size_t size) {
+    return std::string_view((const char*) data, size);
+  }
+
+  static size_t size(Value value) {
+    return sizeof(Length) + value.size();
+  }
+
+  static void append(std::string &buffer, Value value) {
+    if ((Length) -1 < value.size())
+      throw std::invalid_argument("String field too long: " + std::to_string(value.size()));
+    Number<Length>::append(buffer, (Length) value.size());
+    buffer.append(value);
+  }
+};
+
+typedef String<uint8_t> U8String;
+typedef String<uint16_t> U16String;
+
+// Characters sent without length, like textual UUIDs and node keys.
+template<size_t Size>
+struct Fixed {
+  typedef std::string_view Value;
+
+  static size_t receive(TCPHandler &handler, size_t &size) {
+    size = Size;
+    return handler.take(Size);
+  }
+
+  static Value value(const uint8_t *data, size_t) {
+    return std::string_view((const char*) data, Size);
+  }
+
+  static size_t size(Value) {
+    return Size;
+  }
+
+  static void append(std::string &buffer, Value value) {
+    if (value.size() != Size)
+      throw std::invalid_argument("Fixed field of " + std::to_string(Size) + " bytes with " + std::to_string(value.size()));
+    buffer.append(value);
+  }
+};
+
+typedef Fixed<36> UUID;
+
+// Layout of a message as the list of its fields, e.g.
+//
+//   typedef Message<U16String, U8String, U32> SignIn;
+//   auto [token, context, version] = SignIn::read(handler);
+//
+// The fields are received into one contiguous block and checksummed with a
+// single pass over it, or taken in place from a V2 frame. String values are
+// views of that block and stay valid until the next message is read.
+template<typename ... Fields>
+class Message {
+public:
+  typedef std::tuple<typename Fields::Value...> Values;
+
+  // Receives the fields and verifies the checksum that follows them.
+  static Values read(TCPHandler &handler) {
+    Values values = receive(handler);
+    uint32_t crc = handler.readChecksum();
+    if (crc != handler.messageChecksum())
+      throw TransmissionErrorException("Invalid message checksum", 0);
+    return values;
+  }
+
+  // Receives the fields of a message sent without checksum.
+  static Values receive(TCPHandler &handler) {
+    return receive(handler, std::index_sequence_for<Fields...>());
+  }
+
+  // Sends the fields followed by their checksum.
+  static void write(TCPHandler &handler, const typename Fields::Value &... values) {
+    std::string buffer;
+    buffer.reserve((Fields::size(values) + ...));
+    (Fields::append(buffer, values), ...);
+    handler.writeMessage(buffer.data(), buffer.size());
+  }
+
+private:
+  template<size_t ... Index>
+  static Values receive(TCPHandler &handler, std::index_sequence<Index...>) {
+    size_t offsets[sizeof...(Fields)];
+    size_t sizes[sizeof...(Fields)];
+    handler.beginMessage();
+    ((offsets[Index] = Fields::receive(handler, sizes[Index])), ...);
+    const uint8_t *data = handler.message();
+    return Values(Fields::value(data + offsets[Index], sizes[Index])...);
+  }
+};
+
+} /* namespace TCP */
+} /* namespace Services */
+} /* namespace Beehive */
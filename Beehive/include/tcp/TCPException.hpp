@@ -60,6 +60,15 @@ private:
   const std::string _what;
 };
 
+// Thrown when a marked message runs out of input before it is complete, see
+// TCPHandler::mark().
+class IncompleteMessageException: public std::exception {
+public:
+  virtual const char* what() const noexcept override {
+    return "Incomplete message";
+  }
+};
+
 } /* namespace TCP */
 } /* namespace Services */
 } /* namespace Beehive */
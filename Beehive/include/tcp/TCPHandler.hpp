@@ -27,51 +27,289 @@ SOFTWARE.
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <unistd.h>
+#include <vector>
+
+#include <tcp/Checksum.hpp>
+#include <tcp/Compression.hpp>
 
 namespace Beehive {
 namespace Services {
 namespace TCP {
 
+// Message framing negotiated by a client. V1 messages are a sequence of
+// fields followed by their checksum, V2 messages are frames made of the
+// operation (u8), flags (u8), payload length (u32), the payload and the
+// checksum of everything before it, so a whole message is received and
+// verified before it is dispatched. With the Compressed flag the payload is
+// its size (u32) followed by the compressed bytes. With the Tagged flag the
+// (expanded) payload starts with a request id (u32) that is echoed in the
+// reply, so a client can have several requests in flight on a session.
+enum class Framing : uint8_t {
+  V1 = 1, V2 = 2
+};
+
+enum FrameFlags : uint8_t {
+  Compressed = 1, Tagged = 2
+};
+
 class TCPHandler {
 public:
+  static constexpr std::chrono::seconds IdleTimeout = std::chrono::seconds(15);
+
   TCPHandler(int socket) :
-      _socket(socket) {
+      _socket(socket), _idleTimeout(IdleTimeout), _checksum(Checksum::CRC16), _compression(Compression::None), _framing(Framing::V1),
+      _deadline(std::chrono::steady_clock::now()), _inputBegin(0), _inputEnd(0), _marked(false), _mark(0), _partial(false),
+      _outputEnd(0), _incomingEnd(0), _frameBegin(0), _inFrame(false), _messageBegin(0),
+      _replying(false), _replyOperation(0), _replyChecksum(Checksum::CRC16), _replyCompression(Compression::None),
+      _requestTagged(false), _requestId(0), _replyTagged(false) {
   }
   virtual ~TCPHandler() {
   }
 
+  // Processes the requests available on the socket. Returns true while the
+  // connection has to be kept open waiting for more input.
+  virtual bool resume() = 0;
+
+  // Whether input that was not processed yet is buffered. Input given back
+  // by rewind() does not count until more arrives.
+  bool buffered() const {
+    return _inputBegin != _inputEnd && !_partial;
+  }
+
+  // Whether a request has been partially received and the handler is
+  // waiting for the rest of it.
+  bool receiving() const {
+    return _incomingEnd != 0 || _partial;
+  }
+
+  // Sets the time available to receive and answer the next message.
+  void arm(std::chrono::milliseconds timeout) {
+    _deadline = std::chrono::steady_clock::now() + timeout;
+  }
+
+  // Time the event loop may wait for input before closing the connection:
+  // the idle timeout, or what is left of the deadline while a request is
+  // being received.
+  std::chrono::milliseconds timeout() const;
+
+  // Time the connection may wait for input before the event loop closes it.
+  std::chrono::seconds idleTimeout() const {
+    return _idleTimeout;
+  }
+
+  void idleTimeout(std::chrono::seconds idleTimeout) {
+    _idleTimeout = idleTimeout;
+  }
+
+  // Whether a request can be read without waiting: input is buffered or the
+  // socket has data or was closed.
+  bool available();
+
+  // Keeps the input from here on buffered. Until unmark(), running out of
+  // input throws IncompleteMessageException instead of waiting for the
+  // socket, and rewind() goes back to the mark so the message is read again
+  // once more input arrives. A message that does not fit the input buffer
+  // drops the mark and is received waiting like any other.
+  void mark() {
+    _marked = true;
+    _mark = _inputBegin;
+  }
+
+  void rewind() {
+    if (_marked) {
+      _inputBegin = _mark;
+      _partial = true;
+    }
+    _marked = false;
+  }
+
+  void unmark() {
+    _marked = false;
+  }
+
+  // Asks the event loop to resume the handler even if no input arrives. It
+  // can be called from any thread, also through a copy of wakeup().
+  void wake() const {
+    if (_wakeup)
+      _wakeup();
+  }
+
+  const std::function<void()>& wakeup() const {
+    return _wakeup;
+  }
+
+  void wakeup(std::function<void()> wakeup) {
+    _wakeup = std::move(wakeup);
+  }
+
   uint8_t readOperation();
   uint8_t readUInt8(uint8_t max = 0);
-  uint8_t readUInt8C(uint16_t &crc, uint8_t max = 0);
+  uint8_t readUInt8C(uint32_t &crc, uint8_t max = 0);
   uint16_t readUInt16(uint16_t max = 0);
-  uint16_t readUInt16C(uint16_t &crc, uint16_t max = 0);
+  uint16_t readUInt16C(uint32_t &crc, uint16_t max = 0);
   uint32_t readUInt32(uint32_t max = 0);
-  uint32_t readUInt32C(uint16_t &crc, uint32_t max = 0);
+  uint32_t readUInt32C(uint32_t &crc, uint32_t max = 0);
   uint64_t readUInt64(uint64_t max = 0);
-  uint64_t readUInt64C(uint16_t &crc, uint64_t max = 0);
+  uint64_t readUInt64C(uint32_t &crc, uint64_t max = 0);
   void readChar(char *ptr, ssize_t size);
-  void readCharC(char *ptr, ssize_t size, uint16_t &crc);
+  void readCharC(char *ptr, ssize_t size, uint32_t &crc);
   void readUUID(char *ptr);
-  void readUUIDC(char *ptr, uint16_t &crc);
+  void readUUIDC(char *ptr, uint32_t &crc);
 
   void writeUInt8(uint8_t value);
-  void writeUInt8C(uint8_t value, uint16_t &crc);
+  void writeUInt8C(uint8_t value, uint32_t &crc);
   void writeUInt16(uint16_t value);
-  void writeUInt16C(uint16_t value, uint16_t &crc);
+  void writeUInt16C(uint16_t value, uint32_t &crc);
   void writeUInt32(uint32_t value);
-  void writeUInt32C(uint32_t value, uint16_t &crc);
+  void writeUInt32C(uint32_t value, uint32_t &crc);
   void writeUInt64(uint64_t value);
-  void writeUInt64C(uint64_t value, uint16_t &crc);
+  void writeUInt64C(uint64_t value, uint32_t &crc);
   void writeChar(const char *ptr, ssize_t size);
-  void writeCharC(const char *ptr, ssize_t size, uint16_t &crc);
+  void writeCharC(const char *ptr, ssize_t size, uint32_t &crc);
   void writeUUID(const char *ptr);
-  void writeUUIDC(const char *ptr, uint16_t &crc);
+  void writeUUIDC(const char *ptr, uint32_t &crc);
+
+  // The final checksum of a message, its size depends on the negotiated
+  // algorithm.
+  uint32_t readChecksum();
+  void writeChecksum(uint32_t crc);
+
+  Checksum checksum() const {
+    return _checksum;
+  }
+
+  void checksum(Checksum checksum) {
+    _checksum = checksum;
+  }
+
+  Compression compression() const {
+    return _compression;
+  }
+
+  // Compression of the V2 frames sent from now on. Received frames are
+  // decompressed with it when they have the Compressed flag.
+  void compression(Compression compression) {
+    _compression = compression;
+  }
+
+  void dictionary(std::shared_ptr<const Dictionary> dictionary) {
+    _compressor.dictionary(std::move(dictionary));
+  }
+
+  Framing framing() const {
+    return _framing;
+  }
+
+  void framing(Framing framing) {
+    _framing = framing;
+  }
+
+  static void maxFrameSize(uint32_t maxFrameSize) {
+    _maxFrameSize = maxFrameSize;
+  }
+
+  // Collects the available input into the next V2 frame without waiting.
+  // Returns true once the frame is complete or the peer closed the
+  // connection. Frames longer than maxFrameSize are rejected from their
+  // header.
+  bool frameReady();
+
+  // Verifies the frame collected by frameReady(), waiting for it if needed,
+  // and returns its operation, or 0 when the peer closed the connection. The
+  // field readers then read from the payload without accumulating checksums,
+  // and readChecksum() checks that the payload was consumed and returns 0.
+  uint8_t readFrame();
+
+  // Collects the fields written until endFrame() into a V2 frame. A reply is
+  // tagged with the request id of the last frame read, notifications sent
+  // on the server's initiative are not. The frame is
+  // checksummed and compressed with the algorithms in use when it was begun,
+  // so a negotiation only applies to later frames. Payloads under
+  // MinCompressedSize or that do not shrink are sent uncompressed.
+  void beginFrame(uint8_t operation, bool reply = true);
+  void endFrame();
+  // Drops what was written to the reply frame, keeping it open.
+  void discardFrame();
+
+  bool replying() const {
+    return _replying;
+  }
+
+  // Contiguous block of the fields of a message (see Message.hpp): the frame
+  // payload inside a V2 frame, otherwise a buffer the fields are received
+  // into. take() returns the offset of the next size bytes from message(),
+  // which may move while the message is being received.
+  void beginMessage();
+  size_t take(size_t size);
+
+  const uint8_t* message() const {
+    return _inFrame ? _frame.data() + _messageBegin : _message.data();
+  }
+
+  // Checksum of the message block, 0 inside a V2 frame like readChecksum().
+  uint32_t messageChecksum() const;
+
+  // Sends an encoded message followed by its checksum.
+  void writeMessage(const void *ptr, size_t size);
+
+  // Sends every pending byte of the output buffer. It is done implicitly
+  // before waiting for more input, so replies reach the peer before the
+  // handler blocks on the next request.
+  void flush();
 
 private:
-  int _socket;
+  static const size_t BufferSize = 16384;
+  static const size_t FrameHeaderSize = 6;
+  static const size_t MinCompressedSize = 128;
+  static uint32_t _maxFrameSize;
 
+  void update(uint32_t &crc, const void *ptr, size_t size) const;
+  bool await(short events);
+  bool fill(size_t size);
+  size_t frameSize() const;
+  void receive(void *ptr, size_t size);
+  void transmit(const void *ptr, size_t size);
+
+  static uint32_t digest(Checksum checksum, uint32_t crc, const void *ptr, size_t size);
+
+  int _socket;
+  std::chrono::seconds _idleTimeout;
+  std::function<void()> _wakeup;
+  Checksum _checksum;
+  Compression _compression;
+  Compressor _compressor;
+  Framing _framing;
+  std::chrono::steady_clock::time_point _deadline;
+  uint8_t _input[BufferSize];
+  size_t _inputBegin;
+  size_t _inputEnd;
+  bool _marked;
+  size_t _mark;
+  bool _partial;
+  uint8_t _output[BufferSize];
+  size_t _outputEnd;
+  std::vector<uint8_t> _incoming;
+  size_t _incomingEnd;
+  std::vector<uint8_t> _frame;
+  size_t _frameBegin;
+  bool _inFrame;
+  std::vector<uint8_t> _message;
+  size_t _messageBegin;
+  std::vector<uint8_t> _reply;
+  bool _replying;
+  uint8_t _replyOperation;
+  Checksum _replyChecksum;
+  Compression _replyCompression;
+  bool _requestTagged;
+  uint32_t _requestId;
+  bool _replyTagged;
+  std::vector<uint8_t> _scratch;
 };
 
 } /* namespace TCP */
@@ -0,0 +1,95 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Beehive {
+namespace Services {
+namespace TCP {
+
+// Hierarchical hashed timer wheel. Timers are intrusive nodes, so scheduling
+// and cancelling are O(1) and do not allocate. It is not synchronized, the
+// owner thread is the only one allowed to touch it.
+class TimerWheel {
+public:
+  class Timer {
+    friend class TimerWheel;
+  public:
+    Timer() :
+        _next(nullptr), _prev(nullptr), _expires(0) {
+    }
+
+    bool scheduled() const {
+      return _prev != nullptr;
+    }
+
+  private:
+    Timer *_next;
+    Timer *_prev;
+    uint64_t _expires;
+  };
+
+  TimerWheel(std::chrono::milliseconds resolution);
+
+  void schedule(Timer *timer, std::chrono::milliseconds timeout);
+  void cancel(Timer *timer);
+
+  // Milliseconds until the next tick that has work to do, -1 when there are no
+  // timers scheduled. Suitable as the timeout of epoll_wait.
+  int timeout();
+
+  // Advances the wheel up to the current time and returns the expired timers
+  // linked through next(), or nullptr if none expired.
+  Timer* advance();
+
+  static Timer* next(Timer *timer) {
+    return timer->_next;
+  }
+
+private:
+  static const int Levels = 4;
+  static const int SlotBits = 6;
+  static const uint64_t Slots = 1 << SlotBits;
+  static const uint64_t SlotMask = Slots - 1;
+
+  uint64_t ticks();
+  void place(Timer *timer);
+  void unlink(Timer *timer);
+
+  std::chrono::milliseconds _resolution;
+  std::chrono::steady_clock::time_point _start;
+  uint64_t _current;
+  size_t _count;
+  Timer _slots[Levels][Slots];
+};
+
+} /* namespace TCP */
+} /* namespace Services */
+} /* namespace Beehive */
@@ -0,0 +1,86 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <sol/sol.hpp>
+#include <config/Context.hpp>
+#include <string/ICaseMap.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace Beehive {
+namespace Services {
+namespace Utils {
+
+class TransactionsManager;
+
+// Lua interpreters kept per worker thread, one for each context snapshot the
+// thread has served. A state is bootstrapped once from the precompiled
+// transaction bytecode and then reused for every header of that context.
+class LuaPool {
+public:
+  class State {
+  public:
+    // Registry references to the entity name and to id indexed tables of its
+    // key and attribute names, so marshalling pushes names without hashing.
+    struct Names {
+      int entity;
+      int keys;
+      int attributes;
+    };
+
+    State(const std::shared_ptr<Config::Context> &context);
+
+    virtual ~State() {
+    }
+
+    const Names& names(const Config::Entity &entity);
+
+    sol::state lua;
+    std::unordered_map<std::string, sol::protected_function, IHasher, IEqualsComparator> onValidation;
+    std::unordered_map<std::string, sol::protected_function, IHasher, IEqualsComparator> onCommit;
+    std::weak_ptr<Config::Context> context;
+    TransactionsManager *owner;
+
+  private:
+    std::unordered_map<const Config::Entity*, Names> _names;
+
+    void load(std::unordered_map<std::string, sol::protected_function, IHasher, IEqualsComparator> &functions, const std::string &transaction, const std::string &bytecode);
+  };
+
+  static State& acquire(const std::shared_ptr<Config::Context> &context, TransactionsManager *owner);
+  static std::string compile(const std::string &transaction, const std::string &script);
+
+private:
+  static constexpr size_t MaxStates = 8;
+};
+
+} /* namespace Utils */
+} /* namespace Services */
+} /* namespace Beehive */
@@ -0,0 +1,89 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <sol/sol.hpp>
+#include <config/Entity.hpp>
+#include <entities/KeyData.hpp>
+#include <sqlite/BinaryDecoder.hpp>
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace Beehive {
+namespace Services {
+namespace Utils {
+
+// Result of a read() call from a validation script. Rows keep their encoded
+// key and data buffers and only decode a field when the script indexes it.
+// The entity must outlive the rows, which holds while the context that owns
+// the Lua state is alive.
+class LuaRowSet {
+public:
+  class Row {
+  public:
+    Row(std::shared_ptr<const std::vector<Entities::KeyData>> rows, size_t index, const Config::Entity *entity) :
+        _rows(std::move(rows)), _index(index), _entity(entity) {
+    }
+
+    virtual ~Row() {
+    }
+
+    sol::object get(std::string_view name, sol::this_state state) const;
+
+  private:
+    std::shared_ptr<const std::vector<Entities::KeyData>> _rows;
+    size_t _index;
+    const Config::Entity *_entity;
+  };
+
+  LuaRowSet(std::vector<Entities::KeyData> rows, const Config::Entity *entity) :
+      _rows(std::make_shared<const std::vector<Entities::KeyData>>(std::move(rows))), _entity(entity) {
+  }
+
+  virtual ~LuaRowSet() {
+  }
+
+  size_t size() const {
+    return _rows->size();
+  }
+
+  sol::object row(sol::stack_object index, sol::this_state state) const;
+  std::tuple<sol::object, sol::object> next(sol::object control, sol::this_state state) const;
+
+  static void define(sol::state &lua);
+
+private:
+  std::shared_ptr<const std::vector<Entities::KeyData>> _rows;
+  const Config::Entity *_entity;
+};
+
+} /* namespace Utils */
+} /* namespace Services */
+} /* namespace Beehive */
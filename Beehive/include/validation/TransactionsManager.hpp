@@ -36,6 +36,11 @@ SOFTWARE.
 #include <nanolog/NanoLog.hpp>
 #include <sqlite/BinaryDecoder.hpp>
 #include <string/ICaseMap.hpp>
+#include <validation/LuaPool.hpp>
+#include <validation/LuaRowSet.hpp>
+
+#include <memory>
+#include <string_view>
 #include <unordered_map>
 
 namespace Beehive {
@@ -52,56 +57,40 @@ inline void onPanic(sol::optional<std::string> message) {
 class TransactionsManager {
 public:
   TransactionsManager() :
-    _lua(sol::c_call<decltype(&onPanic), &onPanic>) {
-    _lua.open_libraries(sol::lib::table, sol::lib::string, sol::lib::math, sol::lib::base);
-    _lua.set_function("log", [&](std::string message) {
-      LOG_INFO << message;
-    });
-
-    _lua.set_function("read", [&](std::string entity, sol::table data) {
-      return readEntity(entity, data);
-    });
-
-    _lua.set_function("save", [&](std::string entity, sol::table data) {
-      return saveEntity(entity, data);
-    });
-
-    _lua.set_function("update", [&](std::string entity, sol::table data) {
-      return updateEntity(entity, data);
-    });
-
-    _lua.set_function("remove", [&](std::string entity, sol::table key) {
-      return removeEntity(entity, key);
-    });
+    _state(nullptr), _entityDAO(nullptr), _batch(nullptr) {
   }
 
   virtual ~TransactionsManager() {
   }
 
-  void context(Config::Context *context) {
-    _context = context;
+  void context(std::shared_ptr<Config::Context> context) {
+    _context = std::move(context);
   }
 
   void entityDAO(DAO::EntityDAO *entityDAO) {
     _entityDAO = entityDAO;
   }
 
-  sol::table readEntity(std::string entity, sol::table data);
+  LuaRowSet readEntity(std::string entity, sol::table data);
   int saveEntity(std::string entity, sol::table data);
   int updateEntity(std::string entity, sol::table data);
   int removeEntity(std::string entity, sol::table key);
 
-  void loadValidation(std::string transaction, std::string script);
-  void loadCommit(std::string transaction, std::string script);
-  bool executeValidation(Entities::Header &header);
-  bool executeCommit(Entities::Header &header);
+  // The entities read and written by the scripts go through the context
+  // handle of the header and are added to its batch until executeCommit()
+  // returns.
+  bool executeValidation(Entities::Header &header, const DAO::Storage::ContextHandle &context, DAO::Storage::Batch &batch);
+  bool executeCommit(Entities::Header &header, const DAO::Storage::ContextHandle &context, DAO::Storage::Batch &batch);
 
 private:
-  sol::state _lua;
-  std::unordered_map<std::string, sol::load_result, IHasher, IEqualsComparator> _onValidation;
-  std::unordered_map<std::string, sol::load_result, IHasher, IEqualsComparator> _onCommit;
-  Config::Context *_context;
+  void pushRow(lua_State *L, int record, int names, const std::string_view &data);
+  void pushRecord(lua_State *L, const LuaPool::State::Names &names, const Config::Entity &entity, const std::string_view &pk, const std::string_view &data);
+
+  LuaPool::State *_state;
+  std::shared_ptr<Config::Context> _context;
   DAO::EntityDAO *_entityDAO;
+  DAO::Storage::ContextHandle _handle;
+  DAO::Storage::Batch *_batch;
 };
 
 } /* namespace Utils */
@@ -0,0 +1,84 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <validation/Validator.hpp>
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Beehive {
+namespace Services {
+namespace Utils {
+
+// Gathers the values checked by the same validator across all the changes of
+// a header so each expression is evaluated over a contiguous column instead
+// of once per change.
+class ValidationBatch {
+public:
+  ValidationBatch(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) :
+      _columns(resource), _index(resource) {
+  }
+
+  virtual ~ValidationBatch() {
+  }
+
+  void add(Validator *validator, const std::string &entity, const std::string &attribute, long value);
+  void add(Validator *validator, const std::string &entity, const std::string &attribute, double value);
+  void add(Validator *validator, const std::string &entity, const std::string &attribute, std::string_view value);
+
+  // Throws DataValidationException for the first rejected value of the first
+  // column with failures.
+  void validate();
+
+private:
+  struct Column {
+    Column(Validator *validator, const std::string &entity, const std::string &attribute, std::pmr::memory_resource *resource) :
+        validator(validator), entity(&entity), attribute(&attribute), integer(false), numbers(resource), texts(resource) {
+    }
+
+    Validator *validator;
+    const std::string *entity;
+    const std::string *attribute;
+    bool integer;
+    std::pmr::vector<double> numbers;
+    std::pmr::vector<std::string_view> texts;
+  };
+
+  Column& column(Validator *validator, const std::string &entity, const std::string &attribute);
+
+  std::pmr::vector<Column> _columns;
+  std::pmr::unordered_map<Validator*, size_t> _index;
+};
+
+} /* namespace Utils */
+} /* namespace Services */
+} /* namespace Beehive */
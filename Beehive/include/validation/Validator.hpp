@@ -31,44 +31,57 @@ SOFTWARE.
 #include <exprtk/exprtk.hpp>
 #include <services/ServiceException.hpp>
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
 namespace Beehive {
 namespace Services {
 namespace Utils {
 
-class Validator {
+// Check expression of an attribute. The expression is parsed once when the
+// context is compiled; each worker thread evaluates it through its own
+// Evaluator, so a validator is shared by every thread without locking.
+class Validator : public std::enable_shared_from_this<Validator> {
 public:
-  Validator(std::string &attribute, std::string &expression, int type) :
-      _numericValue(0.0) {
-    if (type == SqLite::AttributeType::Integer || type == SqLite::AttributeType::Real) {
-      _symbol_table.add_variable("value", _numericValue);
-      _expression.register_symbol_table(_symbol_table);
-    } else if (type == SqLite::AttributeType::Text) {
-      _symbol_table.add_stringvar("value", _stringValue);
-      _expression.register_symbol_table(_symbol_table);
-    }
-    exprtk::parser<double> parser;
-    if (!parser.compile(expression, _expression))
-      throw Beehive::Services::InvalidSchemaException("Invalid expression check on attributes " + attribute);
-  }
+  Validator(std::string &attribute, std::string &expression, int type);
 
   virtual ~Validator() {
   }
 
-  bool isValidValue(double value) {
-    _numericValue = value;
-    return _expression.value();
-  }
+  bool isValidValue(double value);
+  bool isValidValue(std::string_view value);
 
-  bool isValidValue(std::string value) {
-    _stringValue = value;
-    return _expression.value();
-  }
+  // Evaluates the expression over a column of values, setting bit i of
+  // failures for each rejected values[i]. Returns the number of rejections.
+  size_t validate(const double *values, size_t size, uint64_t *failures);
+  size_t validate(const std::string_view *values, size_t size, uint64_t *failures);
 
 private:
-  std::string _stringValue;
-  double _numericValue;
-  exprtk::symbol_table<double> _symbol_table;
-  exprtk::expression<double> _expression;
+  class Evaluator {
+  public:
+    Evaluator(const Validator &validator);
+
+    virtual ~Evaluator() {
+    }
+
+    std::weak_ptr<const Validator> validator;
+    std::string stringValue;
+    double numericValue;
+    exprtk::symbol_table<double> symbolTable;
+    exprtk::expression<double> expression;
+  };
+
+  Evaluator& evaluator();
+
+  std::string _attribute;
+  std::string _expression;
+  int _type;
+  uint64_t _serial;
+
+  static std::atomic<uint64_t> _serials;
 };
 
 } /* namespace Utils */
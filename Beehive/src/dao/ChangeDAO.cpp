@@ -26,6 +26,8 @@ SOFTWARE.
 
 
 #include <dao/ChangeDAO.hpp>
+#include <dao/KeyCodec.hpp>
+#include <dao/Record.hpp>
 #include <dao/Storage.hpp>
 
 #include <sqlite/BinaryDecoder.hpp>
@@ -40,61 +42,38 @@ namespace DAO {
 
 std::string ChangeDAO::prefix("C.");
 
-void ChangeDAO::save(Entities::Change &change, const std::string &context) {
-/*  SQL::Statement *stmt;
-  stmt = _connection->prepareStatement("INSERT INTO changes(`iddataset`,`idheader`,`idchange`,`operation`,`entity`,`key`,`old`,`data`) VALUES(?, ?, ?, ?, ?, ?, ?, ?);");
-  stmt->setInt(1, change.idDataset());
-  stmt->setInt(2, change.idHeader());
-  stmt->setInt(3, change.idChange());
-  stmt->setInt(4, change.operation());
-  stmt->setUUID(5, change.entityUUID());
-  switch (change.operation()) {
-  case SqLite::Operation::Insert:
-    stmt->setString(6, change.newPK());
-    stmt->setString(7, "");
-    stmt->setString(8, change.newData());
-    break;
-  case SqLite::Operation::Update:
-    stmt->setString(6, change.newPK());
-    stmt->setString(7, change.oldPK());
-    stmt->setString(8, change.newData());
-    break;
-  case SqLite::Operation::Delete:
-    stmt->setString(6, change.oldPK());
-    stmt->setString(7, "");
-    stmt->setString(8, "");
-    break;
-  }
-  stmt->executeUpdate();*/
+void ChangeDAO::save(Entities::ChangeView &change, const Storage::ContextHandle &context) {
+  Storage::Batch batch;
+  save(change, context, batch);
+  Storage::commit(batch);
+}
+
+void ChangeDAO::save(Entities::ChangeView &change, const Storage::ContextHandle &context, Storage::Batch &batch) {
+  KeyCodec key(prefix);
+  key.putUint32(change.idDataset()).putUint32(change.idHeader()).putUint16(change.idChange());
+  batch.putValue(key.key(), Record::encode(change), context);
 }
 
-std::vector<Entities::Change> ChangeDAO::readByHeader(uint32_t idDataset, uint32_t idHeader, const std::unordered_map<std::string, Config::Entity, Utils::IHasher, Utils::IEqualsComparator> &entities, const std::unordered_map<std::string, std::unordered_set<int>> &entitiesByNode, const std::string &context) {
+std::vector<Entities::Change> ChangeDAO::readByHeader(uint32_t idDataset, uint32_t idHeader, const std::unordered_map<std::string, Config::Entity, Utils::IHasher, Utils::IEqualsComparator> &entities, const std::unordered_map<std::string, std::unordered_set<int>> &entitiesByNode, const Storage::ContextHandle &context) {
   std::vector<Entities::Change> changes;
-/*
-  SQL::Statement *stmt;
-  SQL::ResultSet *res;
-  stmt = _connection->prepareStatement("SELECT `iddataset`,`idheader`,`idchange`,`operation`,`entity`,`key`,`old`,`data` FROM `changes` WHERE `iddataset` = ? AND `idheader` = ?;");
-  stmt->setInt(1, idDataset);
-  stmt->setInt(2, idHeader);
-  res = stmt->executeQuery();
-  while (res->next()) {
+  KeyCodec headerKey(prefix);
+  headerKey.putUint32(idDataset).putUint32(idHeader);
+  for (Storage::Scan scan = Storage::scan(headerKey.key(), context); scan.valid(); scan.next()) {
     Entities::Change change;
-    std::string entityUUID = res->getUUID("entity");
-    auto entityPtr = entities.find(entityUUID);
-    auto entityByNodePtr = entitiesByNode.find(entityUUID);
+    Record::decode(std::string_view(scan.value().data(), scan.value().size()), change);
+    auto entityPtr = entities.find(change.entityUUID());
+    auto entityByNodePtr = entitiesByNode.find(change.entityUUID());
     if (entityPtr == entities.end() || entityByNodePtr == entitiesByNode.end())
       continue;
-    change.idDataset(res->getInt("iddataset"));
-    change.idHeader(res->getInt("idheader"));
-    change.idChange(res->getInt("idchange"));
-    change.operation(res->getInt("operation"));
+    KeyCodec::Reader reader(std::string_view(scan.key().data(), scan.key().size()), headerKey.key().size());
+    change.idDataset(idDataset);
+    change.idHeader(idHeader);
+    change.idChange(reader.getUint16());
     change.entityName(entityPtr->second.name);
     switch (change.operation()) {
     case SqLite::Operation::Insert: {
-      std::string opPK = res->getString("key");
-      std::string opData = res->getString("data");
-      SqLite::BinaryDecoder newPK(opPK.c_str(), opPK.size());
-      SqLite::BinaryDecoder newData(opData.c_str(), opData.size());
+      SqLite::BinaryDecoder newPK(change.newPK().c_str(), change.newPK().size());
+      SqLite::BinaryDecoder newData(change.newData().c_str(), change.newData().size());
       SqLite::TextEncoder newTextPK(entityPtr->second.keysId2Name);
       SqLite::TextEncoder newTextData(entityPtr->second.attributesId2Name);
       for (SqLite::BinaryDecoder::Value &value : newPK) {
@@ -111,12 +90,9 @@ std::vector<Entities::Change> ChangeDAO::readByHeader(uint32_t idDataset, uint32
     }
       break;
     case SqLite::Operation::Update: {
-      std::string opPK = res->getString("key");
-      std::string opOPK = res->getString("old");
-      std::string opData = res->getString("data");
-      SqLite::BinaryDecoder newPK(opPK.c_str(), opPK.size());
-      SqLite::BinaryDecoder oldPK(opOPK.c_str(), opOPK.size());
-      SqLite::BinaryDecoder newData(opData.c_str(), opData.size());
+      SqLite::BinaryDecoder newPK(change.newPK().c_str(), change.newPK().size());
+      SqLite::BinaryDecoder oldPK(change.oldPK().c_str(), change.oldPK().size());
+      SqLite::BinaryDecoder newData(change.newData().c_str(), change.newData().size());
       SqLite::TextEncoder newTextPK(entityPtr->second.keysId2Name);
       SqLite::TextEncoder oldTextPK(entityPtr->second.keysId2Name);
       SqLite::TextEncoder newTextData(entityPtr->second.attributesId2Name);
@@ -137,8 +113,7 @@ std::vector<Entities::Change> ChangeDAO::readByHeader(uint32_t idDataset, uint32
     }
       break;
     case SqLite::Operation::Delete: {
-      std::string opPK = res->getString("key");
-      SqLite::BinaryDecoder oldPK(opPK.c_str(), opPK.size());
+      SqLite::BinaryDecoder oldPK(change.oldPK().c_str(), change.oldPK().size());
       SqLite::TextEncoder oldTextPK(entityPtr->second.keysId2Name);
       for (SqLite::BinaryDecoder::Value &value : oldPK) {
         oldTextPK.addValue(value);
@@ -150,10 +125,8 @@ std::vector<Entities::Change> ChangeDAO::readByHeader(uint32_t idDataset, uint32
     }
       break;
     }
-    changes.push_back(change);
+    changes.push_back(std::move(change));
   }
-  delete res;
-  */
   return changes;
 }
 
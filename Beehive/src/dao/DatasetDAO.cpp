@@ -47,7 +47,7 @@ void DatasetDAO::save(Entities::Dataset &dataset, const std::string &context) {
   */
 }
 
-std::unique_ptr<Entities::Dataset> DatasetDAO::read(uint32_t id, const std::string &context) {
+std::unique_ptr<Entities::Dataset> DatasetDAO::read(uint32_t id, const Storage::ContextHandle &context) {
     std::unique_ptr<Entities::Dataset> dataset;
     /*
   SQL::Statement *stmt;
@@ -111,7 +111,14 @@ std::vector<Entities::Dataset> DatasetDAO::readByUser(std::string uuidUser, cons
     return datasets;
 }
 
-int DatasetDAO::update(Entities::Dataset &dataset, const std::string &context) {
+int DatasetDAO::update(Entities::Dataset &dataset, const Storage::ContextHandle &context) {
+    Storage::Batch batch;
+    int result = update(dataset, context, batch);
+    Storage::commit(batch);
+    return result;
+}
+
+int DatasetDAO::update(Entities::Dataset &dataset, const Storage::ContextHandle &context, Storage::Batch &batch) {
 /*    SQL::Statement *stmt;
     stmt = _connection->prepareStatement("UPDATE `datasets` SET `idheader` = ?, `status` = ? WHERE `iddataset` = ?;");
     stmt->setInt(1, dataset.idHeader());
@@ -26,6 +26,8 @@ SOFTWARE.
 
 
 #include <dao/DownloadedDAO.hpp>
+#include <dao/KeyCodec.hpp>
+#include <dao/Record.hpp>
 #include <dao/Storage.hpp>
 
 namespace Beehive {
@@ -34,33 +36,40 @@ namespace DAO {
 
 std::string DownloadedDAO::prefix("d.");
 
-void DownloadedDAO::save(std::string uuidNode, uint32_t idDataset, uint32_t idHeader, uint32_t idCell, const std::string &context) {
-/*  SQL::Statement *stmt;
-  stmt = _connection->prepareStatement("REPLACE INTO `downloaded`(`idnode`, `iddataset`, `idheader`, `idcell`) VALUES(?, ?, ?, ?);");
-  stmt->setInt(1, idNode);
-  stmt->setInt(2, idDataset);
-  stmt->setInt(3, idHeader);
-  stmt->setInt(4, idCell);
-  stmt->executeUpdate();
-  */
+void DownloadedDAO::save(std::string uuidNode, uint32_t idDataset, uint32_t idHeader, uint32_t idCell, const Storage::ContextHandle &context) {
+  Storage::Batch batch;
+  save(uuidNode, idDataset, idHeader, idCell, context, batch);
+  Storage::commit(batch);
 }
 
-std::pair<uint32_t, uint32_t> DownloadedDAO::read(std::string uuidNode, uint32_t idDataset, const std::string &context) {
+void DownloadedDAO::save(std::string uuidNode, uint32_t idDataset, uint32_t idHeader, uint32_t idCell, const Storage::ContextHandle &context, Storage::Batch &batch) {
+  KeyCodec key(prefix);
+  key.putUUID(uuidNode).putUint32(idDataset);
+  Record::Writer value(Record::Type::downloaded);
+  value.put(1, idHeader);
+  value.put(2, idCell);
+  batch.putValue(key.key(), value.data(), context);
+}
+
+std::pair<uint32_t, uint32_t> DownloadedDAO::read(std::string uuidNode, uint32_t idDataset, const Storage::ContextHandle &context) {
   uint32_t idHeader = 0;
   uint32_t idCell = 0;
-/*
-  SQL::Statement *stmt;
-  SQL::ResultSet *res;
-  stmt = _connection->prepareStatement("SELECT `idheader`, `idcell` FROM `downloaded` WHERE `idnode` = ? AND `iddataset` = ?;");
-  stmt->setInt(1, _idNode);
-  stmt->setInt(2, idDataset);
-  res = stmt->executeQuery();
-  if (res->next()) {
-    idHeader = res->getInt("idheader");
-    idCell = res->getInt("idcell");
+  KeyCodec key(prefix);
+  key.putUUID(uuidNode).putUint32(idDataset);
+  std::string value;
+  if (Storage::getValue(key.key(), &value, context)) {
+    Record::Reader reader(value, Record::Type::downloaded);
+    while (reader.next()) {
+      switch (reader.field()) {
+      case 1:
+        idHeader = static_cast<uint32_t>(reader.integer());
+        break;
+      case 2:
+        idCell = static_cast<uint32_t>(reader.integer());
+        break;
+      }
+    }
   }
-  delete res;
-  */
   return std::make_pair(idHeader, idCell);
 }
 
@@ -102,11 +102,11 @@ std::string bin2uuidt(std::string uuid) {
   return std::string(uuidDecoded, 36);
 }
 
-void* EntityDAO::read(uint32_t idDataset, const Config::Entity &entity, const std::string &context) {
+void* EntityDAO::read(uint32_t idDataset, const Config::Entity &entity, const Storage::ContextHandle &context) {
   return 0;
 }
 
-std::vector<Entities::KeyData> EntityDAO::read(uint32_t idDataset, const sol::table &keys, const Config::Entity &entity, const std::string &context) {
+std::vector<Entities::KeyData> EntityDAO::read(uint32_t idDataset, const sol::table &keys, const Config::Entity &entity, const Storage::ContextHandle &context) {
   std::vector<Entities::KeyData> keyDataV;
   /*
   SQL::Statement *stmt;
@@ -205,7 +205,7 @@ std::vector<Entities::KeyData> EntityDAO::read(uint32_t idDataset, const sol::ta
   return keyDataV;
 }
 
-Entities::KeyData EntityDAO::read(Entities::Change &change, const Config::Entity &entity, const std::string &context) {
+Entities::KeyData EntityDAO::read(Entities::ChangeView &change, const Config::Entity &entity, const Storage::ContextHandle &context) {
     Entities::KeyData keyData;
 /*
   SQL::Statement *stmt;
@@ -261,7 +261,7 @@ Entities::KeyData EntityDAO::read(Entities::Change &change, const Config::Entity
   return keyData;
 }
 
-int EntityDAO::save(uint32_t idDataset, const sol::table &data, const Config::Entity &entity, const std::string &context) {
+int EntityDAO::save(uint32_t idDataset, const sol::table &data, const Config::Entity &entity, const Storage::ContextHandle &context, Storage::Batch &batch) {
   /*
   SQL::Statement *stmt;
   std::stringstream ss1;
@@ -400,7 +400,7 @@ int EntityDAO::save(uint32_t idDataset, const sol::table &data, const Config::En
  return 0;
 }
 
-void EntityDAO::save(Entities::Change &change, const Config::Entity &entity, const std::string &context) {
+void EntityDAO::save(Entities::ChangeView &change, const Config::Entity &entity, const Storage::ContextHandle &context, Storage::Batch &batch) {
   /*
   SQL::Statement *stmt;
   std::stringstream ss1;
@@ -457,7 +457,7 @@ void EntityDAO::save(Entities::Change &change, const Config::Entity &entity, con
   */
 }
 
-int EntityDAO::update(uint32_t idDataset, const sol::table &keys, const sol::table &data, const Config::Entity &entity, const std::string &context) {
+int EntityDAO::update(uint32_t idDataset, const sol::table &keys, const sol::table &data, const Config::Entity &entity, const Storage::ContextHandle &context, Storage::Batch &batch) {
   /*
   SQL::Statement *selectStmt;
   SQL::Statement *updateStmt;
@@ -672,7 +672,7 @@ int EntityDAO::update(uint32_t idDataset, const sol::table &keys, const sol::tab
  return 0;
 }
 
-int EntityDAO::update(Entities::Change &change, const Config::Entity &entity, const std::string &context) {
+int EntityDAO::update(Entities::ChangeView &change, const Config::Entity &entity, const Storage::ContextHandle &context, Storage::Batch &batch) {
   /*
   SQL::Statement *stmt;
   std::stringstream ss1;
@@ -762,7 +762,7 @@ int EntityDAO::update(Entities::Change &change, const Config::Entity &entity, co
   return 0;
 }
 
-int EntityDAO::remove(uint32_t idDataset, const sol::table &keys, const Config::Entity &entity, const std::string &context) {
+int EntityDAO::remove(uint32_t idDataset, const sol::table &keys, const Config::Entity &entity, const Storage::ContextHandle &context, Storage::Batch &batch) {
   /*
   SQL::Statement *stmt;
   std::stringstream ss1;
@@ -853,7 +853,7 @@ int EntityDAO::remove(uint32_t idDataset, const sol::table &keys, const Config::
  return 0;
 }
 
-int EntityDAO::remove(Entities::Change &change, const Config::Entity &entity, const std::string &context) {
+int EntityDAO::remove(Entities::ChangeView &change, const Config::Entity &entity, const Storage::ContextHandle &context, Storage::Batch &batch) {
   /*
   SQL::Statement *stmt;
   std::stringstream ss1;
@@ -26,6 +26,8 @@ SOFTWARE.
 
 
 #include <dao/HeaderDAO.hpp>
+#include <dao/KeyCodec.hpp>
+#include <dao/Record.hpp>
 #include <dao/Storage.hpp>
 
 namespace Beehive {
@@ -34,21 +36,19 @@ namespace DAO {
 
 std::string HeaderDAO::prefix("H.");
 
-void HeaderDAO::save(Entities::Header &header, const std::string &context) {
-/*
-  SQL::Statement *stmt;
-  stmt = _connection->prepareStatement("INSERT INTO `headers`(`iddataset`, `idheader`, `transaction`, `node`, `idnode`, `status`) VALUES(?, ?, ?, ?, ?, ?);");
-  stmt->setInt(1, header.idDataset());
-  stmt->setInt(2, header.idHeader());
-  stmt->setUUID(3, header.transactionUUID());
-  stmt->setInt(4, header.node());
-  stmt->setInt(5, header.idNode());
-  stmt->setInt(6, header.status());
-  stmt->executeUpdate();
-  */
+void HeaderDAO::save(Entities::Header &header, const Storage::ContextHandle &context) {
+  Storage::Batch batch;
+  save(header, context, batch);
+  Storage::commit(batch);
 }
 
-std::unique_ptr<Entities::Header> HeaderDAO::read(uint32_t idDataset, uint32_t node, uint32_t idNode, const std::string &context) {
+void HeaderDAO::save(Entities::Header &header, const Storage::ContextHandle &context, Storage::Batch &batch) {
+  KeyCodec key(prefix);
+  key.putUint32(header.idDataset()).putUint32(header.idHeader());
+  batch.putValue(key.key(), Record::encode(header), context);
+}
+
+std::unique_ptr<Entities::Header> HeaderDAO::read(uint32_t idDataset, uint32_t node, uint32_t idNode, const Storage::ContextHandle &context) {
   std::unique_ptr<Entities::Header> header;
 /*
   SQL::Statement *stmt;
@@ -72,27 +72,21 @@ std::unique_ptr<Entities::Header> HeaderDAO::read(uint32_t idDataset, uint32_t n
   return header;
 }
 
-std::vector<Entities::Header> HeaderDAO::readFrom(uint32_t idDataset, uint32_t idHeader, const std::string &context) {
+std::vector<Entities::Header> HeaderDAO::readFrom(uint32_t idDataset, uint32_t idHeader, const Storage::ContextHandle &context) {
   std::vector<Entities::Header> headers;
-/*
-  SQL::Statement *stmt;
-  SQL::ResultSet *res;
-  stmt = _connection->prepareStatement("SELECT `iddataset`, `idheader`, `transaction`, `node`, `idnode`, `date`, `status` FROM `headers` WHERE `iddataset` = ? AND `idheader` > ? ORDER BY `iddataset`, `idheader`;");
-  stmt->setInt(1, idDataset);
-  stmt->setInt(2, idHeader);
-  res = stmt->executeQuery();
-  while (res->next()) {
+  KeyCodec datasetKey(prefix);
+  datasetKey.putUint32(idDataset);
+  KeyCodec fromKey(datasetKey.key());
+  fromKey.putUint32(idHeader);
+  Storage::Scan scan = Storage::scan(datasetKey.key(), context);
+  scan.seek(fromKey.key());
+  if (scan.valid() && scan.key().compare(fromKey.key()) == 0)
+    scan.next();
+  for (; scan.valid(); scan.next()) {
     Entities::Header header;
-    header.idDataset(res->getInt("iddataset"));
-    header.idHeader(res->getInt("idheader"));
-    header.transactionUUID(res->getUUID("transaction"));
-    header.node(res->getInt("node"));
-    header.idNode(res->getInt("idnode"));
-    header.status(res->getInt("status"));
-    headers.push_back(header);
+    Record::decode(std::string_view(scan.value().data(), scan.value().size()), header);
+    headers.push_back(std::move(header));
   }
-  delete res;
-  */
   return headers;
 }
 
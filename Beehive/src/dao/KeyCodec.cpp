@@ -0,0 +1,165 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <dao/KeyCodec.hpp>
+
+#include <dao/Storage.hpp>
+
+namespace Beehive {
+namespace Services {
+namespace DAO {
+
+static int hexValue(char input) {
+    if (input >= '0' && input <= '9')
+        return input - '0';
+    if (input >= 'a' && input <= 'f')
+        return input - 'a' + 10;
+    if (input >= 'A' && input <= 'F')
+        return input - 'A' + 10;
+    return -1;
+}
+
+void KeyCodec::putBigEndian(uint64_t value, size_t size) {
+    for (size_t i = size; i > 0; i--)
+        _key.push_back(static_cast<char>(value >> ((i - 1) * 8)));
+}
+
+KeyCodec &KeyCodec::putUint16(uint16_t value) {
+    putBigEndian(value, 2);
+    return *this;
+}
+
+KeyCodec &KeyCodec::putUint32(uint32_t value) {
+    putBigEndian(value, 4);
+    return *this;
+}
+
+KeyCodec &KeyCodec::putUint64(uint64_t value) {
+    putBigEndian(value, 8);
+    return *this;
+}
+
+KeyCodec &KeyCodec::putUUID(std::string_view uuid) {
+    if (uuid.size() != 36 || uuid[8] != '-' || uuid[13] != '-' || uuid[18] != '-' || uuid[23] != '-')
+        throw StorageException("Invalid uuid '" + std::string(uuid) + "' on storage key.", 0);
+    for (size_t i = 0; i < 36; i += 2) {
+        if (uuid[i] == '-')
+            i++;
+        int high = hexValue(uuid[i]);
+        int low = hexValue(uuid[i + 1]);
+        if (high < 0 || low < 0)
+            throw StorageException("Invalid uuid '" + std::string(uuid) + "' on storage key.", 0);
+        _key.push_back(static_cast<char>(high << 4 | low));
+    }
+    return *this;
+}
+
+KeyCodec &KeyCodec::putString(std::string_view value) {
+    for (char c : value) {
+        _key.push_back(c);
+        if (c == '\0')
+            _key.push_back('\xff');
+    }
+    _key.push_back('\0');
+    _key.push_back('\x01');
+    return *this;
+}
+
+KeyCodec &KeyCodec::putTail(std::string_view value) {
+    _key.append(value.data(), value.size());
+    return *this;
+}
+
+std::string KeyCodec::successor() const {
+    std::string successor = _key;
+    while (!successor.empty() && static_cast<unsigned char>(successor.back()) == 0xff)
+        successor.pop_back();
+    if (!successor.empty())
+        successor.back()++;
+    return successor;
+}
+
+uint64_t KeyCodec::Reader::getBigEndian(size_t size) {
+    if (_key.size() < size)
+        throw StorageException("Invalid storage key.", 0);
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++)
+        value = value << 8 | static_cast<uint8_t>(_key[i]);
+    _key.remove_prefix(size);
+    return value;
+}
+
+uint16_t KeyCodec::Reader::getUint16() {
+    return static_cast<uint16_t>(getBigEndian(2));
+}
+
+uint32_t KeyCodec::Reader::getUint32() {
+    return static_cast<uint32_t>(getBigEndian(4));
+}
+
+uint64_t KeyCodec::Reader::getUint64() {
+    return getBigEndian(8);
+}
+
+std::string KeyCodec::Reader::getUUID() {
+    static const char digits[] = "0123456789abcdef";
+    if (_key.size() < 16)
+        throw StorageException("Invalid storage key.", 0);
+    std::string uuid;
+    uuid.reserve(36);
+    for (size_t i = 0; i < 16; i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10)
+            uuid.push_back('-');
+        uint8_t byte = static_cast<uint8_t>(_key[i]);
+        uuid.push_back(digits[byte >> 4]);
+        uuid.push_back(digits[byte & 0x0f]);
+    }
+    _key.remove_prefix(16);
+    return uuid;
+}
+
+std::string KeyCodec::Reader::getString() {
+    std::string value;
+    for (size_t i = 0; i < _key.size(); i++) {
+        if (_key[i] != '\0') {
+            value.push_back(_key[i]);
+        } else if (i + 1 < _key.size() && _key[i + 1] == '\xff') {
+            value.push_back('\0');
+            i++;
+        } else if (i + 1 < _key.size() && _key[i + 1] == '\x01') {
+            _key.remove_prefix(i + 2);
+            return value;
+        } else {
+            break;
+        }
+    }
+    throw StorageException("Invalid storage key.", 0);
+}
+
+} /* namespace DAO */
+} /* namespace Services */
+} /* namespace Beehive */
@@ -26,7 +26,9 @@ SOFTWARE.
 
 
 #include <dao/NodeDAO.hpp>
+#include <dao/KeyCodec.hpp>
 #include <dao/Storage.hpp>
+#include <dao/Record.hpp>
 
 namespace Beehive {
 namespace Services {
@@ -34,31 +36,49 @@ namespace DAO {
 
 std::string NodeDAO::prefix("N.");
 
+// Nodes are keyed by the raw bytes of the user and node UUIDs so the nodes of
+// a user are contiguous. Nodes written before that used the textual UUIDs;
+// they are still read and are dropped when the node is saved again.
+std::string NodeDAO::key(const std::string &uuidUser, const std::string &uuidNode) {
+    KeyCodec key(prefix);
+    key.putUUID(uuidUser).putUUID(uuidNode);
+    return key.key();
+}
+
+std::string NodeDAO::legacyKey(const std::string &uuidUser, const std::string &uuidNode) {
+    return prefix + uuidUser + uuidNode;
+}
+
 void NodeDAO::save(const Entities::Node &node, Storage::Transaction &transaction) {
-  nlohmann::json json =static_cast<nlohmann::json>(node);
-    std::string value = json.dump();
-    transaction.putValue(prefix + node.user().uuid() + node.uuid(), value, Storage::DefaultContext);
+    std::string value = Record::encode(node);
+    transaction.putValue(key(node.user().uuid(), node.uuid()), value, Storage::DefaultContext);
+    transaction.deleteValue(legacyKey(node.user().uuid(), node.uuid()), Storage::DefaultContext);
 }
 
 std::unique_ptr<Entities::Node> NodeDAO::read(const std::string &uuidNode, const std::string &uuidUser) {
-  std::unique_ptr<Entities::Node> node;
+    std::unique_ptr<Entities::Node> node;
     std::string value;
-    if (Storage::getValue(prefix + uuidUser + uuidNode, &value, Storage::DefaultContext))
-        node = std::make_unique<Entities::Node>(static_cast<Entities::Node>(nlohmann::json::parse(value)));
-  return node;
+    if (Storage::getValue(key(uuidUser, uuidNode), &value, Storage::DefaultContext) || Storage::getValue(legacyKey(uuidUser, uuidNode), &value, Storage::DefaultContext)) {
+        node = std::make_unique<Entities::Node>();
+        Record::decode(value, *node);
+    }
+    return node;
 }
 
 std::unique_ptr<Entities::Node> NodeDAO::read(const std::string &uuidNode, const std::string &uuidUser, Storage::Transaction &transaction) {
-  std::unique_ptr<Entities::Node> node;
+    std::unique_ptr<Entities::Node> node;
     std::string value;
-    if (transaction.getValue(prefix + uuidUser + uuidNode, &value, Storage::DefaultContext))
-        node = std::make_unique<Entities::Node>(static_cast<Entities::Node>(nlohmann::json::parse(value)));
-  return node;
+    if (transaction.getValue(key(uuidUser, uuidNode), &value, Storage::DefaultContext) || transaction.getValue(legacyKey(uuidUser, uuidNode), &value, Storage::DefaultContext)) {
+        node = std::make_unique<Entities::Node>();
+        Record::decode(value, *node);
+    }
+    return node;
 }
 
 int NodeDAO::remove(const std::string &uuidNode, const std::string &uuidUser, Storage::Transaction &transaction) {
-  transaction.deleteValue(prefix + uuidUser + uuidNode, Storage::DefaultContext);
- return 0;
+    transaction.deleteValue(key(uuidUser, uuidNode), Storage::DefaultContext);
+    transaction.deleteValue(legacyKey(uuidUser, uuidNode), Storage::DefaultContext);
+    return 0;
 }
 
 } /* namespace DAO */
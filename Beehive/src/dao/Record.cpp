@@ -0,0 +1,350 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <dao/Record.hpp>
+
+#include <dao/Storage.hpp>
+
+namespace Beehive {
+namespace Services {
+namespace DAO {
+
+enum WireType {
+  varint = 0,
+  bytes = 1
+};
+
+Record::Writer::Writer(Type type) {
+  _data.reserve(64);
+  _data.push_back(static_cast<char>(Version));
+  _data.push_back(static_cast<char>(type));
+}
+
+void Record::Writer::putVarint(uint64_t value) {
+  while (value >= 0x80) {
+    _data.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  _data.push_back(static_cast<char>(value));
+}
+
+void Record::Writer::put(uint32_t field, uint64_t value) {
+  putVarint(static_cast<uint64_t>(field) << 1 | WireType::varint);
+  putVarint(value);
+}
+
+void Record::Writer::put(uint32_t field, std::string_view value) {
+  putVarint(static_cast<uint64_t>(field) << 1 | WireType::bytes);
+  putVarint(value.size());
+  _data.append(value.data(), value.size());
+}
+
+Record::Reader::Reader(std::string_view data, Type type) : _data(data), _field(0), _integer(0) {
+  if (_data.size() < 2 || static_cast<uint8_t>(_data[0]) != Version || static_cast<uint8_t>(_data[1]) != type)
+    throw StorageException("Invalid record format.", 0);
+  _data.remove_prefix(2);
+}
+
+uint64_t Record::Reader::getVarint() {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (_data.empty())
+      break;
+    uint8_t byte = static_cast<uint8_t>(_data.front());
+    _data.remove_prefix(1);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return value;
+  }
+  throw StorageException("Invalid record format.", 0);
+}
+
+bool Record::Reader::next() {
+  if (_data.empty())
+    return false;
+  uint64_t tag = getVarint();
+  _field = static_cast<uint32_t>(tag >> 1);
+  if ((tag & 1) == WireType::varint) {
+    _integer = getVarint();
+    _bytes = std::string_view();
+  } else {
+    uint64_t size = getVarint();
+    if (size > _data.size())
+      throw StorageException("Invalid record format.", 0);
+    _bytes = _data.substr(0, size);
+    _data.remove_prefix(size);
+    _integer = 0;
+  }
+  return true;
+}
+
+std::string Record::encode(const Entities::User &user) {
+  Writer writer(Type::user);
+  writer.put(1, user.uuid());
+  writer.put(2, user.identifier());
+  writer.put(3, user.name());
+  writer.put(4, static_cast<uint64_t>(user.type()));
+  writer.put(5, user.password());
+  writer.put(6, user.salt());
+  return std::move(writer.data());
+}
+
+void Record::decode(std::string_view data, Entities::User &user) {
+  if (isJson(data)) {
+    nlohmann::from_json(nlohmann::json::parse(data.begin(), data.end()), user);
+    return;
+  }
+  user.type(Entities::User::Type::unknown);
+  Reader reader(data, Type::user);
+  while (reader.next()) {
+    switch (reader.field()) {
+    case 1:
+      user.uuid(reader.string());
+      break;
+    case 2:
+      user.identifier(reader.string());
+      break;
+    case 3:
+      user.name(reader.string());
+      break;
+    case 4:
+      user.type(static_cast<Entities::User::Type>(reader.integer()));
+      break;
+    case 5:
+      user.password(reader.string());
+      break;
+    case 6:
+      user.salt(reader.string());
+      break;
+    }
+  }
+}
+
+std::string Record::encode(const Entities::Node &node) {
+  Writer writer(Type::node);
+  writer.put(1, encode(node.user()));
+  writer.put(2, node.key());
+  writer.put(3, node.context());
+  writer.put(4, node.module());
+  writer.put(5, node.uuid());
+  writer.put(6, static_cast<uint64_t>(node.version()));
+  return std::move(writer.data());
+}
+
+void Record::decode(std::string_view data, Entities::Node &node) {
+  if (isJson(data)) {
+    nlohmann::from_json(nlohmann::json::parse(data.begin(), data.end()), node);
+    return;
+  }
+  node.version(0);
+  Reader reader(data, Type::node);
+  while (reader.next()) {
+    switch (reader.field()) {
+    case 1: {
+      Entities::User user;
+      decode(reader.bytes(), user);
+      node.user(user);
+    }
+      break;
+    case 2:
+      node.key(reader.string());
+      break;
+    case 3:
+      node.context(reader.string());
+      break;
+    case 4:
+      node.module(reader.string());
+      break;
+    case 5:
+      node.uuid(reader.string());
+      break;
+    case 6:
+      node.version(static_cast<uint32_t>(reader.integer()));
+      break;
+    }
+  }
+}
+
+std::string Record::encode(const Entities::Dataset &dataset) {
+  Writer writer(Type::dataset);
+  writer.put(1, static_cast<uint64_t>(dataset.id()));
+  writer.put(2, dataset.uuid());
+  writer.put(3, static_cast<uint64_t>(dataset.idHeader()));
+  writer.put(4, dataset.owner());
+  writer.put(5, static_cast<uint64_t>(dataset.status()));
+  return std::move(writer.data());
+}
+
+void Record::decode(std::string_view data, Entities::Dataset &dataset) {
+  dataset.id(0);
+  dataset.idHeader(0);
+  dataset.status(0);
+  Reader reader(data, Type::dataset);
+  while (reader.next()) {
+    switch (reader.field()) {
+    case 1:
+      dataset.id(static_cast<uint32_t>(reader.integer()));
+      break;
+    case 2:
+      dataset.uuid(reader.string());
+      break;
+    case 3:
+      dataset.idHeader(static_cast<uint32_t>(reader.integer()));
+      break;
+    case 4:
+      dataset.owner(reader.string());
+      break;
+    case 5:
+      dataset.status(static_cast<uint8_t>(reader.integer()));
+      break;
+    }
+  }
+}
+
+std::string Record::encode(const Entities::Member &member) {
+  Writer writer(Type::member);
+  writer.put(1, static_cast<uint64_t>(member.idDataset()));
+  writer.put(2, member.idUser());
+  writer.put(3, member.role());
+  writer.put(4, member.name());
+  writer.put(5, member.email());
+  writer.put(6, static_cast<uint64_t>(member.status()));
+  return std::move(writer.data());
+}
+
+void Record::decode(std::string_view data, Entities::Member &member) {
+  member.idDataset(0);
+  member.status(0);
+  Reader reader(data, Type::member);
+  while (reader.next()) {
+    switch (reader.field()) {
+    case 1:
+      member.idDataset(static_cast<uint32_t>(reader.integer()));
+      break;
+    case 2:
+      member.idUser(reader.string());
+      break;
+    case 3:
+      member.role(reader.string());
+      break;
+    case 4:
+      member.name(reader.string());
+      break;
+    case 5:
+      member.email(reader.string());
+      break;
+    case 6:
+      member.status(static_cast<uint8_t>(reader.integer()));
+      break;
+    }
+  }
+}
+
+std::string Record::encode(const Entities::Header &header) {
+  Writer writer(Type::header);
+  writer.put(1, static_cast<uint64_t>(header.idDataset()));
+  writer.put(2, static_cast<uint64_t>(header.idHeader()));
+  writer.put(3, header.transactionUUID());
+  writer.put(4, static_cast<uint64_t>(header.node()));
+  writer.put(5, static_cast<uint64_t>(header.idNode()));
+  writer.put(6, static_cast<uint64_t>(header.status()));
+  writer.put(7, static_cast<uint64_t>(header.version()));
+  return std::move(writer.data());
+}
+
+void Record::decode(std::string_view data, Entities::Header &header) {
+  header.idDataset(0);
+  header.idHeader(0);
+  header.node(0);
+  header.idNode(0);
+  header.status(0);
+  header.version(0);
+  Reader reader(data, Type::header);
+  while (reader.next()) {
+    switch (reader.field()) {
+    case 1:
+      header.idDataset(static_cast<uint32_t>(reader.integer()));
+      break;
+    case 2:
+      header.idHeader(static_cast<uint32_t>(reader.integer()));
+      break;
+    case 3:
+      header.transactionUUID(reader.string());
+      break;
+    case 4:
+      header.node(static_cast<uint32_t>(reader.integer()));
+      break;
+    case 5:
+      header.idNode(static_cast<uint32_t>(reader.integer()));
+      break;
+    case 6:
+      header.status(static_cast<uint8_t>(reader.integer()));
+      break;
+    case 7:
+      header.version(static_cast<uint32_t>(reader.integer()));
+      break;
+    }
+  }
+}
+
+std::string Record::encode(const Entities::ChangeView &change) {
+  Writer writer(Type::change);
+  writer.put(1, static_cast<uint64_t>(change.operation()));
+  writer.put(2, change.entityUUID());
+  writer.put(3, change.newPK());
+  writer.put(4, change.oldPK());
+  writer.put(5, change.newData());
+  return std::move(writer.data());
+}
+
+void Record::decode(std::string_view data, Entities::Change &change) {
+  change.operation(0);
+  Reader reader(data, Type::change);
+  while (reader.next()) {
+    switch (reader.field()) {
+    case 1:
+      change.operation(static_cast<uint8_t>(reader.integer()));
+      break;
+    case 2:
+      change.entityUUID(reader.string());
+      break;
+    case 3:
+      change.newPK(reader.string());
+      break;
+    case 4:
+      change.oldPK(reader.string());
+      break;
+    case 5:
+      change.newData(reader.string());
+      break;
+    }
+  }
+}
+
+} /* namespace DAO */
+} /* namespace Services */
+} /* namespace Beehive */
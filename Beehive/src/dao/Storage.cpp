@@ -36,16 +36,30 @@ namespace Services {
 namespace DAO {
 
 rocksdb::TransactionDB *Storage::db;
-std::vector<rocksdb::ColumnFamilyHandle *> Storage::handles;
-std::unordered_map<std::string, rocksdb::ColumnFamilyHandle *> Storage::handlesMap;
+StorageProfile Storage::profile;
+std::atomic<std::shared_ptr<const Storage::HandleTable>> Storage::handles;
+std::mutex Storage::handlesMutex;
+std::mutex Storage::commitMutex;
+std::condition_variable Storage::commitCondition;
+std::deque<Storage::Writer *> Storage::commitQueue;
+bool Storage::committing = false;
 
 const std::string databaseName = "/tmp/Beehive";
 const std::string Storage::DefaultContext = "default";
 
-void Storage::open() {
+std::shared_ptr<rocksdb::ColumnFamilyHandle> Storage::family(rocksdb::ColumnFamilyHandle *handle) {
+    return std::shared_ptr<rocksdb::ColumnFamilyHandle>(handle, [](rocksdb::ColumnFamilyHandle *handle) {
+        if (!db->DestroyColumnFamilyHandle(handle).ok())
+            LOG_ERROR << "Unable to close column family";
+    });
+}
+
+void Storage::open(const std::string &profile) {
     std::vector<std::string> columnFamiliesNames;
     std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilies;
-    rocksdb::Options dbo;
+    std::vector<rocksdb::ColumnFamilyHandle *> columnFamiliesHandles;
+    Storage::profile = StorageProfile::load(profile);
+    rocksdb::Options dbo(Storage::profile.dbOptions(), Storage::profile.familyOptions(DefaultContext));
     rocksdb::TransactionDBOptions tdbo;
 
     dbo.create_if_missing = true;
@@ -61,82 +75,154 @@ void Storage::open() {
         }
     }
     for (std::string name : columnFamiliesNames)
-        columnFamilies.push_back(rocksdb::ColumnFamilyDescriptor(name, rocksdb::ColumnFamilyOptions()));
-    if (!rocksdb::TransactionDB::Open(dbo, tdbo, databaseName, columnFamilies, &handles, &db).ok()) {
+        columnFamilies.push_back(rocksdb::ColumnFamilyDescriptor(name, Storage::profile.familyOptions(name)));
+    if (!rocksdb::TransactionDB::Open(dbo, tdbo, databaseName, columnFamilies, &columnFamiliesHandles, &db).ok()) {
         LOG_ERROR << "Unable to open storage";
         exit(1);
     }
-    for (rocksdb::ColumnFamilyHandle *handle : handles)
-        handlesMap.emplace(handle->GetName(), handle);
+    std::shared_ptr<HandleTable> table = std::make_shared<HandleTable>();
+    for (rocksdb::ColumnFamilyHandle *handle : columnFamiliesHandles)
+        table->emplace(handle->GetName(), family(handle));
+    handles.store(std::move(table));
 }
 
 void Storage::createContext(const std::string &uuid) {
     rocksdb::ColumnFamilyHandle *handle;
-    auto handlePtr = handlesMap.find(uuid);
-    if (handlePtr != handlesMap.end())
+    std::lock_guard<std::mutex> lock(handlesMutex);
+    std::shared_ptr<const HandleTable> current = handles.load();
+    if (current->find(uuid) != current->end())
         throw AlreadyExistsException("Context with uuid: " + uuid + " already exists.");
-    rocksdb::Status status = db->CreateColumnFamily(rocksdb::ColumnFamilyOptions(), uuid, &handle);
-    if (status.ok())
-        handlesMap.emplace(handle->GetName(), handle);
-    else
+    rocksdb::Status status = db->CreateColumnFamily(profile.familyOptions(uuid), uuid, &handle);
+    if (!status.ok())
         throw StorageErrorException(status.getState());
+    std::shared_ptr<HandleTable> table = std::make_shared<HandleTable>(*current);
+    table->emplace(handle->GetName(), family(handle));
+    handles.store(std::move(table));
 }
 
 void Storage::deleteContext(const std::string &uuid) {
-    auto handlePtr = handlesMap.find(uuid);
-    if (handlePtr == handlesMap.end())
+    std::lock_guard<std::mutex> lock(handlesMutex);
+    std::shared_ptr<const HandleTable> current = handles.load();
+    auto handlePtr = current->find(uuid);
+    if (handlePtr == current->end())
         throw NotExistsException("Context doesn't exist");
-    if (db->DropColumnFamily(handlePtr->second).ok())
-        handlesMap.erase(handlePtr);
+    if (db->DropColumnFamily(handlePtr->second.get()).ok()) {
+        std::shared_ptr<HandleTable> table = std::make_shared<HandleTable>(*current);
+        table->erase(uuid);
+        handles.store(std::move(table));
+    }
 }
 
 std::vector<std::string> Storage::getContexts() {
     std::vector<std::string> contexts;
-    for (auto handler : handlesMap)
+    std::shared_ptr<const HandleTable> table = handles.load();
+    for (auto &handler : *table)
         if(handler.first != "default")
             contexts.push_back(handler.first);
     return contexts;
 }
 
+Storage::ContextHandle Storage::handle(const std::string &context) {
+    std::shared_ptr<const HandleTable> table = handles.load();
+    auto handlePtr = table->find(context);
+    if (handlePtr == table->end())
+        return ContextHandle();
+    return ContextHandle(handlePtr->second);
+}
+
 void Storage::putValue(const std::string &key, const std::string &value, const std::string &context) {
-    auto handlePtr = handlesMap.find(context);
-    if (handlePtr != handlesMap.end()) {
-        if (!db->Put(rocksdb::WriteOptions(), handlePtr->second, key, value).ok()) {
+    putValue(key, value, handle(context));
+}
+
+void Storage::putValue(const std::string &key, const std::string &value, const ContextHandle &context) {
+    if (context) {
+        if (!db->Put(rocksdb::WriteOptions(), context.get(), key, value).ok()) {
             LOG_ERROR << "Unable to save data";
-            throw StorageException("Error to save data into " + context, 0);
+            throw StorageException("Error to save data into " + context.name(), 0);
         }
     } else
-        throw StorageException("Context" + context + " doesn't exist.", 0);
+        throw StorageException("Context doesn't exist.", 0);
 }
 
 bool Storage::getValue(const std::string &key, std::string *value, const std::string &context) {
-    auto handlePtr = handlesMap.find(context);
-    if (handlePtr != handlesMap.end()) {
-        if (db->Get(rocksdb::ReadOptions(), handlePtr->second, key, value).ok())
+    return getValue(key, value, handle(context));
+}
+
+bool Storage::getValue(const std::string &key, std::string *value, const ContextHandle &context) {
+    if (context) {
+        if (db->Get(rocksdb::ReadOptions(), context.get(), key, value).ok())
             return true;
     }
     return false;
 }
 
 bool Storage::getValues(const std::string &key, std::vector<std::pair<std::string, std::string>> &values, const std::string &context) {
-    auto handlePtr = handlesMap.find(context);
-    if (handlePtr != handlesMap.end()) {
-        rocksdb::Iterator *it = db->NewIterator(rocksdb::ReadOptions(), handlePtr->second);
-        for (it->Seek(key); it->Valid() && it->key().starts_with(key); it->Next())
-            values.push_back(std::make_pair<std::string, std::string>(it->key().ToString(), it->value().ToString()));
-        if (!it->status().ok()) {
-            LOG_ERROR << "Error while retrieving data from: " << it->status().ToString();
-            throw StorageException("Error while retrieving data from " + context, 0);
-        }
+    return getValues(key, values, handle(context));
+}
+
+bool Storage::getValues(const std::string &key, std::vector<std::pair<std::string, std::string>> &values, const ContextHandle &context) {
+    if (context) {
+        for (Scan scan = Storage::scan(key, context); scan.valid(); scan.next())
+            values.emplace_back(scan.key().ToString(), scan.value().ToString());
         return true;
     }
     return false;
 }
 
+Storage::Scan Storage::scan(const std::string &prefix, const std::string &context) {
+    return scan(prefix, handle(context));
+}
+
+Storage::Scan Storage::scan(const std::string &prefix, const ContextHandle &context) {
+    return Scan(context, prefix);
+}
+
+Storage::Scan::Scan(const ContextHandle &context, const std::string &prefix) : _context(context), _upperBound(prefix) {
+    if (!_context)
+        return;
+    while (!_upperBound.empty() && static_cast<unsigned char>(_upperBound.back()) == 0xff)
+        _upperBound.pop_back();
+    rocksdb::ReadOptions options;
+    if (!_upperBound.empty()) {
+        _upperBound.back()++;
+        _upperBoundSlice = rocksdb::Slice(_upperBound);
+        options.iterate_upper_bound = &_upperBoundSlice;
+    }
+    options.auto_prefix_mode = true;
+    options.pin_data = true;
+    options.readahead_size = 2 << 20;
+    options.adaptive_readahead = true;
+    _iterator.reset(db->NewIterator(options, _context.get()));
+    _iterator->Seek(prefix);
+    check();
+}
+
+void Storage::Scan::next() {
+    _iterator->Next();
+    check();
+}
+
+void Storage::Scan::seek(const std::string &key) {
+    if (!_iterator)
+        return;
+    _iterator->Seek(key);
+    check();
+}
+
+void Storage::Scan::check() {
+    if (!_iterator->Valid() && !_iterator->status().ok()) {
+        LOG_ERROR << "Error while retrieving data from: " << _iterator->status().ToString();
+        throw StorageException("Error while retrieving data from " + _context.name(), 0);
+    }
+}
+
 bool Storage::deleteValue(const std::string &key, const std::string &context) {
-    auto handlePtr = handlesMap.find(context);
-    if (handlePtr != handlesMap.end()) {
-        if (db->Delete(rocksdb::WriteOptions(), handlePtr->second, key).ok())
+    return deleteValue(key, handle(context));
+}
+
+bool Storage::deleteValue(const std::string &key, const ContextHandle &context) {
+    if (context) {
+        if (db->Delete(rocksdb::WriteOptions(), context.get(), key).ok())
             return true;
     }
     return false;
@@ -147,41 +233,169 @@ Storage::Transaction Storage::begin() {
 }
 
 void Storage::Transaction::putValue(const std::string &key, const std::string &value, const std::string &context) {
-    auto handlePtr = handlesMap.find(context);
-    if (handlePtr != handlesMap.end()) {
-        if (!_transaction->Put(handlePtr->second, key, value).ok()) {
+    putValue(key, value, handle(context));
+}
+
+void Storage::Transaction::putValue(const std::string &key, const std::string &value, const ContextHandle &context) {
+    if (context) {
+        if (!_transaction->Put(context.get(), key, value).ok()) {
             LOG_ERROR << "Unable to save data";
-            throw StorageException("Error to save data into " + context, 0);
+            throw StorageException("Error to save data into " + context.name(), 0);
         }
     } else
-        throw StorageException("Context" + context + " doesn't exist.", 0);
+        throw StorageException("Context doesn't exist.", 0);
 }
 
 bool Storage::Transaction::getValue(const std::string &key, std::string *value, const std::string &context) {
-    auto handlePtr = handlesMap.find(context);
-    if (handlePtr != handlesMap.end()) {
-        if (_transaction->GetForUpdate(rocksdb::ReadOptions(), handlePtr->second, key, value).ok())
+    return getValue(key, value, handle(context));
+}
+
+bool Storage::Transaction::getValue(const std::string &key, std::string *value, const ContextHandle &context) {
+    if (context) {
+        if (_transaction->GetForUpdate(rocksdb::ReadOptions(), context.get(), key, value).ok())
             return true;
     }
     return false;
 }
 
 bool Storage::Transaction::deleteValue(const std::string &key, const std::string &context) {
-    auto handlePtr = handlesMap.find(context);
-    if (handlePtr != handlesMap.end()) {
-        if (_transaction->Delete(handlePtr->second, key).ok())
+    return deleteValue(key, handle(context));
+}
+
+bool Storage::Transaction::deleteValue(const std::string &key, const ContextHandle &context) {
+    if (context) {
+        if (_transaction->Delete(context.get(), key).ok())
             return true;
     }
     return false;
 }
 
-void Storage::close() {
+struct Storage::Writer {
+    Batch *batch;
     rocksdb::Status status;
-    for (auto handle : handles) {
-        status = db->DestroyColumnFamilyHandle(handle);
-        if (!status.ok())
-            LOG_ERROR << "Unable to close column family";
+    bool done;
+};
+
+// Copies the updates of a batch into the batch written for its commit group.
+class Storage::Appender : public rocksdb::WriteBatch::Handler {
+   public:
+    Appender(rocksdb::WriteBatch &group, const Batch &batch) : _group(group), _batch(batch) {
+    }
+
+    rocksdb::Status PutCF(uint32_t id, const rocksdb::Slice &key, const rocksdb::Slice &value) override {
+        rocksdb::ColumnFamilyHandle *family = _batch.family(id);
+        if (!family)
+            return rocksdb::Status::InvalidArgument("Unknown column family");
+        return _group.Put(family, key, value);
+    }
+
+    rocksdb::Status DeleteCF(uint32_t id, const rocksdb::Slice &key) override {
+        rocksdb::ColumnFamilyHandle *family = _batch.family(id);
+        if (!family)
+            return rocksdb::Status::InvalidArgument("Unknown column family");
+        return _group.Delete(family, key);
+    }
+
+   private:
+    rocksdb::WriteBatch &_group;
+    const Batch &_batch;
+};
+
+void Storage::commit(Batch &batch) {
+    if (batch.empty())
+        return;
+    Writer writer { &batch, rocksdb::Status(), false };
+    std::unique_lock<std::mutex> lock(commitMutex);
+    commitQueue.push_back(&writer);
+    while (!writer.done && (committing || commitQueue.front() != &writer))
+        commitCondition.wait(lock);
+    if (!writer.done) {
+        committing = true;
+        std::vector<Writer*> group(commitQueue.begin(), commitQueue.end());
+        commitQueue.clear();
+        lock.unlock();
+        rocksdb::WriteOptions options;
+        options.sync = true;
+        rocksdb::Status status;
+        if (group.size() == 1) {
+            status = db->Write(options, &group.front()->batch->_batch);
+        } else {
+            rocksdb::WriteBatch merged;
+            for (Writer *member : group) {
+                Appender appender(merged, *member->batch);
+                status = member->batch->_batch.Iterate(&appender);
+                if (!status.ok())
+                    break;
+            }
+            if (status.ok())
+                status = db->Write(options, &merged);
+        }
+        for (Writer *member : group)
+            member->status = status;
+        if (!status.ok() && 1 < group.size()) {
+            // Written one by one, a failing batch does not fail the others.
+            for (Writer *member : group)
+                member->status = db->Write(options, &member->batch->_batch);
+        }
+        lock.lock();
+        for (Writer *member : group)
+            member->done = true;
+        committing = false;
+        commitCondition.notify_all();
+    }
+    if (!writer.status.ok()) {
+        LOG_ERROR << "Unable to commit batch: " << writer.status.ToString();
+        throw StorageException("Unable to commit batch.", 0);
+    }
+}
+
+void Storage::Batch::putValue(const std::string &key, const std::string &value, const std::string &context) {
+    putValue(key, value, handle(context));
+}
+
+void Storage::Batch::putValue(const std::string &key, const std::string &value, const ContextHandle &context) {
+    if (context) {
+        if (!_batch.Put(context.get(), key, value).ok()) {
+            LOG_ERROR << "Unable to save data";
+            throw StorageException("Error to save data into " + context.name(), 0);
+        }
+        if (_contexts.empty() || _contexts.back()._family != context._family)
+            _contexts.push_back(context);
+    } else
+        throw StorageException("Context doesn't exist.", 0);
+}
+
+void Storage::Batch::rollback() {
+    if (!_batch.RollbackToSavePoint().ok())
+        throw StorageException("Unable to rollback a batch.", 0);
+}
+
+rocksdb::ColumnFamilyHandle *Storage::Batch::family(uint32_t id) const {
+    for (const ContextHandle &context : _contexts) {
+        if (context.get()->GetID() == id)
+            return context.get();
     }
+    return nullptr;
+}
+
+void Storage::Batch::deleteValue(const std::string &key, const std::string &context) {
+    deleteValue(key, handle(context));
+}
+
+void Storage::Batch::deleteValue(const std::string &key, const ContextHandle &context) {
+    if (context) {
+        if (!_batch.Delete(context.get(), key).ok()) {
+            LOG_ERROR << "Unable to delete data";
+            throw StorageException("Error to delete data from " + context.name(), 0);
+        }
+        if (_contexts.empty() || _contexts.back()._family != context._family)
+            _contexts.push_back(context);
+    } else
+        throw StorageException("Context doesn't exist.", 0);
+}
+
+void Storage::close() {
+    handles.store(nullptr);
     delete db;
 }
 
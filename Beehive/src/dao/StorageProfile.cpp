@@ -0,0 +1,157 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <dao/StorageProfile.hpp>
+
+#include <dao/Storage.hpp>
+#include <nanolog/NanoLog.hpp>
+
+#include <cstring>
+#include <fstream>
+
+namespace Beehive {
+namespace Services {
+namespace DAO {
+
+// Prefix made of the key up to and including its first '.', keys without a
+// dot ("Schema") are out of the domain and keep whole key filtering.
+class FamilyPrefix: public rocksdb::SliceTransform {
+   public:
+    const char *Name() const override {
+        return "Beehive.FamilyPrefix";
+    }
+
+    rocksdb::Slice Transform(const rocksdb::Slice &key) const override {
+        const char *dot = static_cast<const char*>(memchr(key.data(), '.', key.size()));
+        return rocksdb::Slice(key.data(), dot - key.data() + 1);
+    }
+
+    bool InDomain(const rocksdb::Slice &key) const override {
+        return memchr(key.data(), '.', key.size()) != nullptr;
+    }
+};
+
+static rocksdb::CompressionType compressionType(const std::string &name) {
+    if (name == "none")
+        return rocksdb::kNoCompression;
+    if (name == "snappy")
+        return rocksdb::kSnappyCompression;
+    if (name == "lz4")
+        return rocksdb::kLZ4Compression;
+    if (name == "zstd")
+        return rocksdb::kZSTD;
+    throw StorageException("Unknown compression '" + name + "' on storage profile.", 0);
+}
+
+static rocksdb::CompactionStyle compactionStyle(const std::string &name) {
+    if (name == "level")
+        return rocksdb::kCompactionStyleLevel;
+    if (name == "universal")
+        return rocksdb::kCompactionStyleUniversal;
+    throw StorageException("Unknown compaction style '" + name + "' on storage profile.", 0);
+}
+
+StorageProfile StorageProfile::load(const std::string &profile) {
+    StorageProfile storageProfile;
+    storageProfile.name = "default";
+    storageProfile.blockCacheSize = 64 << 20;
+    storageProfile.blockSize = 16 << 10;
+    storageProfile.bloomBitsPerKey = 10;
+    storageProfile.memtablePrefixBloomRatio = 0.05;
+    storageProfile.cacheIndexAndFilterBlocks = true;
+    storageProfile.backgroundJobs = 2;
+    storageProfile.system = { "lz4", "zstd", "level", 16 << 20, 2, true, false };
+    storageProfile.contexts = { "lz4", "zstd", "level", 64 << 20, 3, true, false };
+    if (profile == "write-heavy") {
+        storageProfile.name = profile;
+        storageProfile.backgroundJobs = 4;
+        storageProfile.contexts = { "lz4", "zstd", "universal", 128 << 20, 4, false, false };
+    } else if (profile == "read-heavy") {
+        storageProfile.name = profile;
+        storageProfile.blockCacheSize = 512 << 20;
+        storageProfile.bloomBitsPerKey = 12;
+        storageProfile.memtablePrefixBloomRatio = 0.1;
+        storageProfile.system.optimizeFiltersForHits = true;
+        storageProfile.contexts.optimizeFiltersForHits = true;
+    } else if (profile == "small") {
+        storageProfile.name = profile;
+        storageProfile.blockCacheSize = 8 << 20;
+        storageProfile.blockSize = 4 << 10;
+        storageProfile.backgroundJobs = 1;
+        storageProfile.system = { "zstd", "zstd", "level", 4 << 20, 2, true, false };
+        storageProfile.contexts = { "zstd", "zstd", "level", 8 << 20, 2, true, false };
+    } else if (profile != "default" && !profile.empty()) {
+        std::ifstream file(profile);
+        if (!file.is_open())
+            throw StorageException("Storage profile " + profile + " was not found.", 0);
+        nlohmann::from_json(nlohmann::json::parse(file), storageProfile);
+    }
+    compressionType(storageProfile.system.compression);
+    compressionType(storageProfile.system.bottommostCompression);
+    compressionType(storageProfile.contexts.compression);
+    compressionType(storageProfile.contexts.bottommostCompression);
+    compactionStyle(storageProfile.system.compactionStyle);
+    compactionStyle(storageProfile.contexts.compactionStyle);
+    rocksdb::BlockBasedTableOptions tableOptions;
+    tableOptions.block_cache = rocksdb::NewLRUCache(storageProfile.blockCacheSize);
+    tableOptions.block_size = storageProfile.blockSize;
+    tableOptions.filter_policy.reset(rocksdb::NewBloomFilterPolicy(storageProfile.bloomBitsPerKey));
+    tableOptions.whole_key_filtering = true;
+    tableOptions.cache_index_and_filter_blocks = storageProfile.cacheIndexAndFilterBlocks;
+    tableOptions.pin_l0_filter_and_index_blocks_in_cache = storageProfile.cacheIndexAndFilterBlocks;
+    storageProfile._tableFactory.reset(rocksdb::NewBlockBasedTableFactory(tableOptions));
+    storageProfile._prefixExtractor = std::make_shared<FamilyPrefix>();
+    LOG_INFO << "Using storage profile " << storageProfile.name;
+    return storageProfile;
+}
+
+rocksdb::DBOptions StorageProfile::dbOptions() const {
+    rocksdb::DBOptions options;
+    options.max_background_jobs = backgroundJobs;
+    options.bytes_per_sync = 1 << 20;
+    return options;
+}
+
+rocksdb::ColumnFamilyOptions StorageProfile::familyOptions(const std::string &family) const {
+    const Family &settings = family == Storage::DefaultContext ? system : contexts;
+    rocksdb::ColumnFamilyOptions options;
+    options.table_factory = _tableFactory;
+    options.prefix_extractor = _prefixExtractor;
+    options.memtable_prefix_bloom_size_ratio = memtablePrefixBloomRatio;
+    options.compression = compressionType(settings.compression);
+    options.bottommost_compression = compressionType(settings.bottommostCompression);
+    options.compaction_style = compactionStyle(settings.compactionStyle);
+    options.write_buffer_size = settings.writeBufferSize;
+    options.max_write_buffer_number = settings.maxWriteBufferNumber;
+    options.level_compaction_dynamic_level_bytes = settings.dynamicLevelBytes;
+    options.optimize_filters_for_hits = settings.optimizeFiltersForHits;
+    return options;
+}
+
+} /* namespace DAO */
+} /* namespace Services */
+} /* namespace Beehive */
@@ -27,6 +27,9 @@ SOFTWARE.
 
 #include <dao/UserDAO.hpp>
 
+#include <dao/KeyCodec.hpp>
+#include <dao/Record.hpp>
+
 namespace Beehive {
 namespace Services {
 namespace DAO {
@@ -48,9 +51,10 @@ std::unique_ptr<Entities::Developer> UserDAO::readAdmin(const std::string &ident
 }
 
 void UserDAO::save(Entities::User &user, const std::string &context, Storage::Transaction &transaction) {
-    std::string value = static_cast<nlohmann::json>(user).dump();
-    transaction.putValue(prefix + user.identifier(), value, context);
-    transaction.putValue(ixprefix + user.uuid(), user.identifier(), context);
+    std::string value = Record::encode(user);
+    Storage::ContextHandle handle = Storage::handle(context);
+    transaction.putValue(prefix + user.identifier(), value, handle);
+    transaction.putValue(KeyCodec(ixprefix).putUUID(user.uuid()).key(), user.identifier(), handle);
 }
 
 std::unique_ptr<Entities::User> UserDAO::read(const std::string &identifier, const std::string &context) {
@@ -58,8 +62,7 @@ std::unique_ptr<Entities::User> UserDAO::read(const std::string &identifier, con
     std::string userBody;
     if (Storage::getValue(prefix + identifier, &userBody, context)) {
         user = std::make_unique<Entities::User>();
-        nlohmann::json bodyJson = nlohmann::json::parse(userBody);
-        nlohmann::from_json(bodyJson, *user);
+        Record::decode(userBody, *user);
     }
     return user;
 }
@@ -67,7 +70,9 @@ std::unique_ptr<Entities::User> UserDAO::read(const std::string &identifier, con
 std::unique_ptr<Entities::User> UserDAO::readByUUID(const std::string &uuid, const std::string &context) {
     std::unique_ptr<Entities::User> user;
     std::string identifier;
-    if (Storage::getValue(ixprefix + uuid, &identifier, context)) {
+    Storage::ContextHandle handle = Storage::handle(context);
+    // Index entries written before the binary keys hold the textual UUID.
+    if (Storage::getValue(KeyCodec(ixprefix).putUUID(uuid).key(), &identifier, handle) || Storage::getValue(ixprefix + uuid, &identifier, handle)) {
         user = read(identifier, context);
     }
     return user;
@@ -75,28 +80,29 @@ std::unique_ptr<Entities::User> UserDAO::readByUUID(const std::string &uuid, con
 
 std::vector<Entities::User> UserDAO::read(const std::string &context) {
     std::vector<Entities::User> users;
-    std::vector<std::pair<std::string, std::string>> values;
-    if (Storage::getValues(prefix, values, context)) {
-        for (auto pair : values) {
-            Entities::User user;
-            nlohmann::json bodyJson = nlohmann::json::parse(pair.second);
-            nlohmann::from_json(bodyJson, user);
-            users.push_back(std::move(user));
-        }
+    for (Storage::Scan scan = Storage::scan(prefix, context); scan.valid(); scan.next()) {
+        if (scan.key().starts_with(ixprefix))
+            continue;
+        Entities::User user;
+        Record::decode(std::string_view(scan.value().data(), scan.value().size()), user);
+        users.push_back(std::move(user));
     }
     return users;
 }
 
 void UserDAO::update(Entities::User &user, const std::string &context, Storage::Transaction &transaction) {
-    std::string value = static_cast<nlohmann::json>(user).dump();
+    std::string value = Record::encode(user);
     transaction.putValue(prefix + user.identifier(), value, context);
 }
 
 void UserDAO::remove(const std::string &uuid, const std::string &context, Storage::Transaction &transaction) {
     std::string identifier;
-    if (Storage::getValue(ixprefix + uuid, &identifier, context)) {
-        transaction.deleteValue(prefix + identifier, context);
-        transaction.deleteValue(ixprefix + uuid, context);
+    Storage::ContextHandle handle = Storage::handle(context);
+    std::string key = KeyCodec(ixprefix).putUUID(uuid).key();
+    if (Storage::getValue(key, &identifier, handle) || Storage::getValue(ixprefix + uuid, &identifier, handle)) {
+        transaction.deleteValue(prefix + identifier, handle);
+        transaction.deleteValue(key, handle);
+        transaction.deleteValue(ixprefix + uuid, handle);
     }
 }
 
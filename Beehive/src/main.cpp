@@ -36,6 +36,7 @@ SOFTWARE.
 #include <services/InboundTCP.hpp>
 #include <services/OutboundHTTP.hpp>
 #include <services/UserService.hpp>
+#include <tcp/Compression.hpp>
 #include <thread>
 
 Beehive::Services::InboundHTTP inboundHTTP;
@@ -58,7 +59,11 @@ int main(int, char **) {
         signal(SIGINT, signalHandler);
         signal(SIGTERM, signalHandler);
 
-        Beehive::Services::DAO::Storage::open();
+        const char *storageProfile = getenv("BEEHIVE_STORAGE_PROFILE");
+        Beehive::Services::DAO::Storage::open(storageProfile ? storageProfile : "default");
+        const char *dictionaries = getenv("BEEHIVE_DICTIONARIES");
+        if (dictionaries)
+            Beehive::Services::TCP::Dictionary::directory(dictionaries);
 
         Beehive::Services::UserService::checkAdmin();
         std::thread inboundHTTPThread([] {
@@ -0,0 +1,101 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <services/ContextRegistry.hpp>
+
+#include <nanolog/NanoLog.hpp>
+#include <services/SchemaService.hpp>
+#include <validation/LuaPool.hpp>
+#include <validation/Validator.hpp>
+
+namespace Beehive {
+namespace Services {
+
+std::atomic<std::shared_ptr<const ContextRegistry::Snapshot>> ContextRegistry::_snapshot;
+std::mutex ContextRegistry::_mutex;
+
+std::shared_ptr<Config::Context> ContextRegistry::get(const std::string &uuid, uint32_t version) {
+    std::shared_ptr<const Snapshot> snapshot = _snapshot.load(std::memory_order_acquire);
+    if (snapshot) {
+        auto contextPtr = snapshot->find(uuid);
+        if (contextPtr != snapshot->end()) {
+            auto versionPtr = contextPtr->second.find(version);
+            if (versionPtr != contextPtr->second.end())
+                return versionPtr->second;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    snapshot = _snapshot.load(std::memory_order_acquire);
+    if (snapshot) {
+        auto contextPtr = snapshot->find(uuid);
+        if (contextPtr != snapshot->end()) {
+            auto versionPtr = contextPtr->second.find(version);
+            if (versionPtr != contextPtr->second.end())
+                return versionPtr->second;
+        }
+    }
+    std::shared_ptr<Config::Context> context = std::make_shared<Config::Context>(SchemaService::getContext(uuid, version));
+    compile(*context);
+    std::shared_ptr<Snapshot> next = snapshot ? std::make_shared<Snapshot>(*snapshot) : std::make_shared<Snapshot>();
+    (*next)[uuid][version] = context;
+    _snapshot.store(next, std::memory_order_release);
+    LOG_INFO << "Context " << uuid << " version " << version << " loaded.";
+    return context;
+}
+
+void ContextRegistry::invalidate(const std::string &uuid) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::shared_ptr<const Snapshot> snapshot = _snapshot.load(std::memory_order_acquire);
+    if (!snapshot || snapshot->find(uuid) == snapshot->end())
+        return;
+    std::shared_ptr<Snapshot> next = std::make_shared<Snapshot>(*snapshot);
+    next->erase(uuid);
+    _snapshot.store(next, std::memory_order_release);
+}
+
+void ContextRegistry::compile(Config::Context &context) {
+    try {
+        for (auto &transaction : context.transactions) {
+            if (transaction.second.pre != "")
+                transaction.second.preBytecode = Utils::LuaPool::compile(transaction.second.uuid, transaction.second.pre);
+            if (transaction.second.post != "")
+                transaction.second.postBytecode = Utils::LuaPool::compile(transaction.second.uuid, transaction.second.post);
+        }
+        for (auto &entity : context.entities) {
+            for (auto &attribute : entity.second.attributes) {
+                if (attribute.second.check && (attribute.second.type == SqLite::AttributeType::Integer || attribute.second.type == SqLite::AttributeType::Real || attribute.second.type == SqLite::AttributeType::Text)) {
+                    attribute.second.validator = std::make_shared<Utils::Validator>(attribute.second.name, *attribute.second.check, attribute.second.type);
+                }
+            }
+        }
+    } catch (std::exception &e) {
+        LOG_ERROR << e.what();
+    }
+}
+
+} /* namespace Services */
+} /* namespace Beehive */
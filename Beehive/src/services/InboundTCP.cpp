@@ -34,7 +34,6 @@ SOFTWARE.
 #include <stdio.h>
 #include <sys/socket.h>
 #include <sys/types.h>
-#include <tcp/SocketWatcher.hpp>
 #include <tcp/TCPException.hpp>
 #include <unistd.h>
 
@@ -47,6 +46,9 @@ SOFTWARE.
 namespace Beehive {
 namespace Services {
 
+uint32_t InboundTCP::_maxConnections = 10000;
+uint32_t InboundTCP::_workers = std::thread::hardware_concurrency();
+
 void InboundTCP::start() {
     LOG_INFO << "Starting Bin Server";
     if (0 <= (_tcpSocket = socket(AF_INET6, SOCK_STREAM, 0))) {
@@ -58,21 +60,10 @@ void InboundTCP::start() {
         serverAddr.sin6_addr = in6addr_any;
         if (setsockopt(_tcpSocket, SOL_SOCKET, SO_REUSEADDR, (char *)&on, sizeof(on)) == 0 && bind(_tcpSocket, (struct sockaddr *)&serverAddr, sizeof(serverAddr)) == 0 && listen(_tcpSocket, 50) == 0) {
             LOG_INFO << "Waiting for incoming connections...";
-            int clientSocket = 0;
-            while (0 < (clientSocket = accept(_tcpSocket, NULL, NULL))) {
-                std::thread([&](int clientSocket) {
-                    struct sockaddr_in6 clientaddr;
-                    unsigned int addrlen = sizeof(clientaddr);
-                    char str[INET6_ADDRSTRLEN];
-                    getpeername(clientSocket, (struct sockaddr *)&clientaddr, &addrlen);
-                    if (inet_ntop(AF_INET6, &clientaddr.sin6_addr, str, sizeof(str))) {
-                        LOG_DEBUG << "Connection received form: " << str << ":" << ntohs(clientaddr.sin6_port);
-                    }
-                    BinSyncHandlerIntance binSyncHandlerIntance(clientSocket);
-                    binSyncHandlerIntance.run();
-                    close(clientSocket);
-                }, clientSocket).detach();
-            }
+            _eventLoop.run(_tcpSocket, _maxConnections, _workers, [](int clientSocket) {
+                return new BinSyncHandlerIntance(clientSocket);
+            });
+            close(_tcpSocket);
         } else {
             LOG_ERROR << "Unable to open a socket: " << strerror(errno);
             exit(1);
@@ -85,242 +76,66 @@ void InboundTCP::start() {
 }
 
 void InboundTCP::finish() {
-  close(_tcpSocket);
+    _eventLoop.finish();
 }
 
 using namespace __cxxabiv1;
 
-void BinSyncHandlerIntance::run(void) {
+bool BinSyncHandlerIntance::resume() {
+    bool keep = false;
     try {
-        uint8_t option = readUInt8();
-        std::unique_ptr<Services::Entities::Node> node;
-        switch (option) {
-            case 'I': {
-                uint16_t crc;
-                crc = 0x0000;
-                uint16_t sizeToken = readUInt16C(crc);
-                char token[sizeToken];
-                readCharC(token, sizeToken, crc);
-                uint8_t sizeContext = readUInt8C(crc);
-                char contextChar[sizeContext];
-                readCharC(contextChar, sizeContext, crc);
-                uint8_t sizeModule = readUInt8C(crc);
-                char moduleChar[sizeModule];
-                readCharC(moduleChar, sizeModule, crc);
-                uint8_t sizeNodeUUID = readUInt8C(crc);
-                char nodeUUID[sizeNodeUUID];
-                readCharC(nodeUUID, sizeNodeUUID, crc);
-                uint32_t version = readUInt32C(crc);
-                uint16_t finalCRC = readUInt16();
-                if (finalCRC == crc) {
-                    UserService userService;
-                    std::string contextString(contextChar, sizeContext);
-                    std::string moduleString(moduleChar, sizeModule);
-                    node = userService.signIn(std::string(token, sizeToken), contextString, moduleString, std::string(nodeUUID, sizeNodeUUID), 0);
-                    writeUInt8(Codes::success);
-                    crc = 0x0000;
-                    writeCharC(node->user().uuid().data(), node->user().uuid().size(), crc);
-                    writeCharC(node->nodeKey().data(), node->nodeKey().size(), crc);
-                    writeUInt16(crc);
-                } else {
-                    writeUInt8(Codes::messageTransmissionError);
-                }
-            }
-                return;
-            case 'S': {
-                uint16_t crc;
-                crc = 0x0000;
-                uint16_t sizeEmail = readUInt8C(crc);
-                char email[sizeEmail];
-                readCharC(email, sizeEmail, crc);
-                uint16_t sizePassword = readUInt8C(crc);
-                char password[sizePassword];
-                readCharC(password, sizePassword, crc);
-                uint8_t sizeContext = readUInt8C(crc);
-                char contextChar[sizeContext];
-                readCharC(contextChar, sizeContext, crc);
-                uint8_t sizeModule = readUInt8C(crc);
-                char moduleChar[sizeModule];
-                readCharC(moduleChar, sizeModule, crc);
-                uint8_t sizeNodeUUID = readUInt8C(crc);
-                char nodeUUID[sizeNodeUUID];
-                readCharC(nodeUUID, sizeNodeUUID, crc);
-                uint32_t version = readUInt32C(crc);
-                uint16_t finalCRC = readUInt16();
-                if (finalCRC == crc) {
-                    UserService userService;
-                    std::string contextString(contextChar, sizeContext);
-                    std::string moduleString(moduleChar, sizeModule);
-                    node = userService.signIn(std::string(email, sizeEmail), std::string(password, sizePassword), contextString, moduleString, std::string(nodeUUID, sizeNodeUUID));
-                    writeUInt8(Codes::success);
-                    crc = 0x0000;
-                    writeCharC(node->user().uuid().data(), node->user().uuid().size(), crc);
-                    writeCharC(node->nodeKey().data(), node->nodeKey().size(), crc);
-                    writeUInt16(crc);
-                } else {
-                    writeUInt8(Codes::messageTransmissionError);
-                }
-            }
-                return;
-            case 'U': {
-                uint16_t crc;
-                crc = 0x0000;
-                uint16_t sizeName = readUInt8C(crc);
-                char name[sizeName];
-                readCharC(name, sizeName, crc);
-                uint16_t sizeEmail = readUInt8C(crc);
-                char email[sizeEmail];
-                readCharC(email, sizeEmail, crc);
-                uint16_t sizePassword = readUInt8C(crc);
-                char password[sizePassword];
-                readCharC(password, sizePassword, crc);
-                uint8_t sizeContext = readUInt8C(crc);
-                char contextChar[sizeContext];
-                readCharC(contextChar, sizeContext, crc);
-                uint8_t sizeModule = readUInt8C(crc);
-                char moduleChar[sizeModule];
-                readCharC(moduleChar, sizeModule, crc);
-                uint8_t sizeNodeUUID = readUInt8C(crc);
-                char nodeUUID[sizeNodeUUID];
-                readCharC(nodeUUID, sizeNodeUUID, crc);
-                uint32_t version = readUInt32C(crc);
-                uint16_t finalCRC = readUInt16();
-                if (finalCRC == crc) {
-                    UserService userService;
-                    std::string contextString(contextChar, sizeContext);
-                    std::string moduleString(moduleChar, sizeModule);
-                    node = userService.signUp(std::string(name, sizeName), std::string(email, sizeEmail), std::string(password, sizePassword), contextString, moduleString, std::string(nodeUUID, sizeNodeUUID));
-                    writeUInt8(Codes::success);
-                    crc = 0x0000;
-                    writeCharC(node->user().uuid().data(), node->user().uuid().size(), crc);
-                    writeCharC(node->nodeKey().data(), node->nodeKey().size(), crc);
-                    writeUInt16(crc);
-                } else {
-                    writeUInt8(Codes::messageTransmissionError);
-                }
-            }
-                return;
-            case 'F': {
-                uint16_t crc;
-                crc = 0x0000;
-                uint16_t sizeToken = readUInt16C(crc);
-                char token[sizeToken];
-                readCharC(token, sizeToken, crc);
-                uint8_t sizeContext = readUInt8C(crc);
-                char contextChar[sizeContext];
-                readCharC(contextChar, sizeContext, crc);
-                uint16_t finalCRC = readUInt16();
-                if (finalCRC == crc) {
-                    UserService userService;
-                    std::string contextString(contextChar, sizeContext);
-                    userService.signOff(std::string(token, sizeToken), 0, contextString);
-                    writeUInt8(Codes::success);
-                } else {
-                    writeUInt8(Codes::messageTransmissionError);
-                }
-            }
-                return;
-            case 'G': {
-                uint16_t crc;
-                crc = 0x0000;
-                uint16_t sizeEmail = readUInt8C(crc);
-                char email[sizeEmail];
-                readCharC(email, sizeEmail, crc);
-                uint16_t sizePassword = readUInt8C(crc);
-                char password[sizePassword];
-                readCharC(password, sizePassword, crc);
-                uint8_t sizeContext = readUInt8C(crc);
-                char contextChar[sizeContext];
-                readCharC(contextChar, sizeContext, crc);
-                uint16_t finalCRC = readUInt16();
-                if (finalCRC == crc) {
-                    UserService userService;
-                    std::string contextString(contextChar, sizeContext);
-                    userService.signOff(std::string(email, sizeEmail), std::string(password, sizePassword), contextString);
-                    writeUInt8(Codes::success);
-                } else {
-                    writeUInt8(Codes::messageTransmissionError);
-                }
-            }
-                return;
-            case 'C': {
-                char key[28];
-                readChar(key, 28);
-                UserService userService;
-                node = userService.reconnect(std::string(key, 28));
-                node->version(readUInt32());
-                writeUInt8(Codes::success);
-            } break;
+        if (_subscription)
+            deliver();
+        if (framing() == TCP::Framing::V2 ? !frameReady() : !available()) {
+            // Woken to send notifications or only part of a frame arrived,
+            // there is no request yet.
+            flush();
+            return true;
         }
-        option = readOperation();
-        switch (option) {
-            case 'O': {
-                UserService userService;
-                userService.signOut(*node);
-                writeUInt8(Codes::success);
-            } break;
-            case 'e':
-                deleteDataset(*node);
-                break;
-            case 'g':
-                pushDataset(*node);
-                break;
-            case 'i':
-                popDataset(*node);
-                break;
-            case 'r':
-                putDataset(*node);
-                break;
-            case 't':
-                pullDataset(*node);
-                break;
-            case 's':
-                leaveDataset(*node);
-                break;
-            case 'k':
-                updateMember(*node);
-                break;
-            case 'l':
-                deleteMember(*node);
-                break;
-            case 'z':
-                fullSync(*node);
-                break;
-            default:
-                throw TCP::TransmissionErrorException("Unknown message: " + std::to_string(option), 0);
+        // A V1 handshake is processed once it has arrived whole, so a client
+        // that sends it slowly does not hold the worker. Signed in clients
+        // wait for the rest of a V1 message.
+        if (framing() == TCP::Framing::V1 && !_node)
+            mark();
+        uint8_t option = framing() == TCP::Framing::V2 ? readFrame() : _node ? readOperation() : readUInt8();
+        if (option == 0) {
+            // readFrame() and readOperation() return 0 once the peer has
+            // closed the connection.
+            return false;
         }
+        if (framing() == TCP::Framing::V2)
+            beginFrame(option);
+        if (_node) {
+            keep = operation(option);
+        } else {
+            keep = handshake(option);
+        }
+        endFrame();
         //_connection->unlock();
+    } catch (TCP::IncompleteMessageException &e) {
+        rewind();
+        return true;
     } catch (TCP::TransmissionErrorException &e) {
         //_connection->rollback();
         //_connection->unlock();
         LOG_ERROR << e.what();
-        try {
-            writeUInt8(Codes::messageTransmissionError);
-        } catch (...) {
-        }
+        fail(Codes::messageTransmissionError);
     } catch (Services::AuthenticationException &e) {
         //_connection->rollback();
         //_connection->unlock();
-        try {
-            writeUInt8(Codes::userNotFound);
-        } catch (...) {
-        }
+        fail(Codes::userNotFound);
     } catch (std::invalid_argument &e) {
         //_connection->rollback();
         //_connection->unlock();
         LOG_ERROR << e.what();
-        try {
-            writeUInt8(Codes::internalError);
-        } catch (...) {
-        }
+        fail(Codes::internalError);
+        keep = recoverable();
     } catch (std::runtime_error &e) {
         //_connection->rollback();
         //_connection->unlock();
         LOG_ERROR << e.what();
-        try {
-            writeUInt8(Codes::internalError);
-        } catch (...) {
-        }
+        fail(Codes::internalError);
+        keep = recoverable();
     } catch (...) {
         //_connection->rollback();
         //_connection->unlock();
@@ -329,26 +144,174 @@ void BinSyncHandlerIntance::run(void) {
         std::string demangled = buff;
         std::free(buff);
         LOG_ERROR << "Unknown exception type: " << demangled;
-        try {
-            writeUInt8(Codes::internalError);
-        } catch (...) {
-        }
+        fail(Codes::internalError);
+        keep = recoverable();
     }
+    unmark();
+    try {
+        flush();
+    } catch (TCP::TransmissionErrorException &e) {
+        LOG_ERROR << e.what();
+        keep = false;
+    }
+    return keep;
 }
 
-void BinSyncHandlerIntance::deleteDataset(Services::Entities::Node &node) {
+// Answers a failed message with an error code. A V2 reply replaces whatever
+// was written to the frame with the code alone.
+void BinSyncHandlerIntance::fail(uint8_t code) {
     try {
-        uint16_t crc;
-        crc = 0x0000;
-        char uuidDataset[36];
-        readUUIDC(uuidDataset, crc);
-        uint16_t finalCRC = readUInt16();
-        if (finalCRC == crc) {
-            //_datasetService.removeDataset(node.user(), std::string(uuidDataset, 36));
+        if (framing() == TCP::Framing::V2 && !replying())
+            beginFrame(0);
+        discardFrame();
+        writeUInt8(code);
+        endFrame();
+    } catch (...) {
+    }
+}
+
+// A V2 frame is received whole before it is dispatched, so after a failed
+// operation the next frame starts where expected and the session can go on.
+bool BinSyncHandlerIntance::recoverable() const {
+    return _node && framing() == TCP::Framing::V2;
+}
+
+bool BinSyncHandlerIntance::handshake(uint8_t option) {
+    std::unique_ptr<Services::Entities::Node> node;
+    switch (option) {
+        case 'I': {
+            auto [token, context, module, nodeUUID, version] = TokenSignIn::read(*this);
+            UserService userService;
+            node = userService.signIn(std::string(token), std::string(context), std::string(module), std::string(nodeUUID), 0);
             writeUInt8(Codes::success);
-        } else {
-            writeUInt8(Codes::messageTransmissionError);
+            Session::write(*this, node->user().uuid(), node->nodeKey());
+        }
+            return false;
+        case 'S': {
+            auto [email, password, context, module, nodeUUID, version] = PasswordSignIn::read(*this);
+            UserService userService;
+            node = userService.signIn(std::string(email), std::string(password), std::string(context), std::string(module), std::string(nodeUUID));
+            writeUInt8(Codes::success);
+            Session::write(*this, node->user().uuid(), node->nodeKey());
+        }
+            return false;
+        case 'U': {
+            auto [name, email, password, context, module, nodeUUID, version] = SignUp::read(*this);
+            UserService userService;
+            node = userService.signUp(std::string(name), std::string(email), std::string(password), std::string(context), std::string(module), std::string(nodeUUID));
+            writeUInt8(Codes::success);
+            Session::write(*this, node->user().uuid(), node->nodeKey());
+        }
+            return false;
+        case 'F': {
+            auto [token, context] = TokenSignOff::read(*this);
+            UserService userService;
+            userService.signOff(std::string(token), 0, std::string(context));
+            writeUInt8(Codes::success);
+        }
+            return false;
+        case 'G': {
+            auto [email, password, context] = PasswordSignOff::read(*this);
+            UserService userService;
+            userService.signOff(std::string(email), std::string(password), std::string(context));
+            writeUInt8(Codes::success);
+        }
+            return false;
+        case 'N': {
+            auto [option, value] = Negotiation::read(*this);
+            writeUInt8(negotiate(option, value) ? Codes::success : Codes::notSupported);
+        }
+            return true;
+        case 'C': {
+            auto [key, version] = Reconnection::receive(*this);
+            UserService userService;
+            node = userService.reconnect(std::string(key));
+            node->version(version);
+            dictionary(TCP::Dictionary::get(node->context()));
+            writeUInt8(Codes::success);
+            _node = std::move(node);
+        }
+            return true;
+        default:
+            throw TCP::TransmissionErrorException("Unknown message: " + std::to_string(option), 0);
+    }
+}
+
+bool BinSyncHandlerIntance::negotiate(uint8_t option, uint8_t value) {
+    switch (option) {
+        case Options::checksumAlgorithm:
+            if (value == (uint8_t)TCP::Checksum::CRC16 || value == (uint8_t)TCP::Checksum::CRC32C) {
+                checksum((TCP::Checksum)value);
+                return true;
+            }
+            return false;
+        case Options::messageFraming:
+            if (value == (uint8_t)TCP::Framing::V1 || value == (uint8_t)TCP::Framing::V2) {
+                framing((TCP::Framing)value);
+                return true;
+            }
+            return false;
+        case Options::payloadCompression:
+            if (value == (uint8_t)TCP::Compression::None || value == (uint8_t)TCP::Compression::LZ4 || value == (uint8_t)TCP::Compression::ZSTD) {
+                compression((TCP::Compression)value);
+                return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+bool BinSyncHandlerIntance::operation(uint8_t option) {
+    switch (option) {
+        case 'O': {
+            UserService userService;
+            userService.signOut(*_node);
+            writeUInt8(Codes::success);
+            _node.reset();
         }
+            return false;
+        case 'e':
+            deleteDataset(*_node);
+            break;
+        case 'g':
+            pushDataset(*_node);
+            break;
+        case 'i':
+            popDataset(*_node);
+            break;
+        case 'r':
+            putDataset(*_node);
+            break;
+        case 't':
+            pullDataset(*_node);
+            break;
+        case 's':
+            leaveDataset(*_node);
+            break;
+        case 'k':
+            updateMember(*_node);
+            break;
+        case 'l':
+            deleteMember(*_node);
+            break;
+        case 'z':
+            fullSync(*_node);
+            break;
+        case 'n':
+            subscribe(*_node);
+            break;
+        default:
+            throw TCP::TransmissionErrorException("Unknown message: " + std::to_string(option), 0);
+    }
+    return true;
+}
+
+void BinSyncHandlerIntance::deleteDataset(Services::Entities::Node &node) {
+    try {
+        auto [uuidDataset] = DatasetRequest::read(*this);
+        //_datasetService.removeDataset(node.user(), std::string(uuidDataset));
+        writeUInt8(Codes::success);
     } catch (Services::NotEnoughRightsException &e) {
         writeUInt8(Codes::notEnoughRights);
     }
@@ -356,28 +319,13 @@ void BinSyncHandlerIntance::deleteDataset(Services::Entities::Node &node) {
 
 void BinSyncHandlerIntance::pushDataset(Services::Entities::Node &node) {
     try {
-        uint16_t crc;
-        crc = 0x0000;
-        char uuidDataset[36];
-        readUUIDC(uuidDataset, crc);
-        uint16_t size1 = readUInt8C(crc);
-        readCharC((char *)_buffer, size1, crc);
-        std::string role((char *)_buffer, size1);
-        uint64_t until = readUInt64C(crc);
-        uint32_t number = readUInt32C(crc);
-        uint16_t finalCRC = readUInt16();
-        if (finalCRC == crc) {
-            //Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
-            //_storageService.context(&context);
-            //_datasetService.context(&context);
-            //Services::Entities::Push push = _datasetService.pushDataset(node, std::string(uuidDataset, 36), role, until, number);
-            //writeUInt8(Codes::success);
-            //crc = 0x0000;
-            //writeUUIDC(push.uuid().data(), crc);
-            //writeUInt16(crc);
-        } else {
-            writeUInt8(Codes::messageTransmissionError);
-        }
+        auto [uuidDataset, role, until, number] = PushRequest::read(*this);
+        //Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
+        //_storageService.context(&context);
+        //_datasetService.context(&context);
+        //Services::Entities::Push push = _datasetService.pushDataset(node, std::string(uuidDataset), std::string(role), until, number);
+        //writeUInt8(Codes::success);
+        //PushReply::write(*this, push.uuid());
     } catch (Services::NotExistsException &e) {
         writeUInt8(Codes::dataNotFound);
     } catch (Services::NotEnoughRightsException &e) {
@@ -389,25 +337,12 @@ void BinSyncHandlerIntance::pushDataset(Services::Entities::Node &node) {
 
 void BinSyncHandlerIntance::popDataset(Services::Entities::Node &node) {
     try {
-        uint16_t crc;
-        crc = 0x0000;
-        char uuidDataset[36];
-        readUUIDC(uuidDataset, crc);
-        readUUIDC((char *)_buffer, crc);
-        std::string uuid((char *)_buffer, 36);
-        uint8_t size1 = readUInt8C(crc);
-        readCharC((char *)_buffer, size1, crc);
-        std::string name((char *)_buffer, size1);
-        uint16_t finalCRC = readUInt16();
-        if (finalCRC == crc) {
-            //Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
-            //_storageService.context(&context);
-            //_datasetService.context(&context);
-            //std::unique_ptr<Services::Entities::Dataset> dataset = _datasetService.popDataset(node, std::string(uuidDataset, 36), uuid, name);
-            writeUInt8(Codes::success);
-        } else {
-            writeUInt8(Codes::messageTransmissionError);
-        }
+        auto [uuidDataset, uuid, name] = PopRequest::read(*this);
+        //Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
+        //_storageService.context(&context);
+        //_datasetService.context(&context);
+        //std::unique_ptr<Services::Entities::Dataset> dataset = _datasetService.popDataset(node, std::string(uuidDataset), std::string(uuid), std::string(name));
+        writeUInt8(Codes::success);
     } catch (Services::NotExistsException &e) {
         writeUInt8(Codes::dataNotFound);
     } catch (Services::InvalidSchemaException &e) {
@@ -417,22 +352,12 @@ void BinSyncHandlerIntance::popDataset(Services::Entities::Node &node) {
 
 void BinSyncHandlerIntance::pullDataset(Services::Entities::Node &node) {
     try {
-        uint16_t crc;
-        crc = 0x0000;
-        char uuidDataset[36];
-        readUUIDC(uuidDataset, crc);
-        readUUIDC((char *)_buffer, crc);
-        std::string uuid((char *)_buffer, 36);
-        uint16_t finalCRC = readUInt16();
-        if (finalCRC == crc) {
-            //Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
-            //_storageService.context(&context);
-            //_datasetService.context(&context);
-            //_datasetService.pullDataset(node, std::string(uuidDataset, 36), uuid);
-            writeUInt8(Codes::success);
-        } else {
-            writeUInt8(Codes::messageTransmissionError);
-        }
+        auto [uuidDataset, uuid] = PullRequest::read(*this);
+        //Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
+        //_storageService.context(&context);
+        //_datasetService.context(&context);
+        //_datasetService.pullDataset(node, std::string(uuidDataset), std::string(uuid));
+        writeUInt8(Codes::success);
     } catch (Services::NotExistsException &e) {
         writeUInt8(Codes::dataNotFound);
     } catch (Services::InvalidSchemaException &e) {
@@ -442,29 +367,12 @@ void BinSyncHandlerIntance::pullDataset(Services::Entities::Node &node) {
 
 void BinSyncHandlerIntance::putDataset(Services::Entities::Node &node) {
     try {
-        uint16_t crc;
-        crc = 0x0000;
-        char uuidDataset[36];
-        readUUIDC(uuidDataset, crc);
-        uint8_t size1 = readUInt8C(crc);
-        readCharC((char *)_buffer, size1, crc);
-        std::string email((char *)_buffer, size1);
-        uint8_t size2 = readUInt8C(crc);
-        readCharC((char *)_buffer, size2, crc);
-        std::string name((char *)_buffer, size2);
-        uint16_t size3 = readUInt8C(crc);
-        readCharC((char *)_buffer, size3, crc);
-        std::string role((char *)_buffer, size3);
-        uint16_t finalCRC = readUInt16();
-        if (finalCRC == crc) {
-            //Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
-            //_storageService.context(&context);
-            //_datasetService.context(&context);
-            //_datasetService.putDataset(node, std::string(uuidDataset, 36), email, name, role);
-            writeUInt8(Codes::success);
-        } else {
-            writeUInt8(Codes::messageTransmissionError);
-        }
+        auto [uuidDataset, email, name, role] = PutRequest::read(*this);
+        //Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
+        //_storageService.context(&context);
+        //_datasetService.context(&context);
+        //_datasetService.putDataset(node, std::string(uuidDataset), std::string(email), std::string(name), std::string(role));
+        writeUInt8(Codes::success);
     } catch (Services::NotExistsException &e) {
         writeUInt8(Codes::dataNotFound);
     } catch (Services::NotEnoughRightsException &e) {
@@ -476,17 +384,9 @@ void BinSyncHandlerIntance::putDataset(Services::Entities::Node &node) {
 
 void BinSyncHandlerIntance::leaveDataset(Services::Entities::Node &node) {
     try {
-        uint16_t crc;
-        crc = 0x0000;
-        char uuidDataset[36];
-        readUUIDC(uuidDataset, crc);
-        uint16_t finalCRC = readUInt16();
-        if (finalCRC == crc) {
-            //_datasetService.leaveDataset(node, std::string(uuidDataset, 36));
-            writeUInt8(Codes::success);
-        } else {
-            writeUInt8(Codes::messageTransmissionError);
-        }
+        auto [uuidDataset] = DatasetRequest::read(*this);
+        //_datasetService.leaveDataset(node, std::string(uuidDataset));
+        writeUInt8(Codes::success);
     } catch (Services::InvalidSchemaException &e) {
         writeUInt8(Codes::invalidSchema);
     }
@@ -494,27 +394,12 @@ void BinSyncHandlerIntance::leaveDataset(Services::Entities::Node &node) {
 
 void BinSyncHandlerIntance::updateMember(Services::Entities::Node &node) {
     try {
-        uint16_t crc;
-        crc = 0x0000;
-        char uuidDataset[36];
-        readUUIDC(uuidDataset, crc);
-        uint32_t idUser = (uint32_t)readUInt64C(crc);
-        uint16_t size1 = readUInt8C(crc);
-        readCharC((char *)_buffer, size1, crc);
-        std::string role((char *)_buffer, size1);
-        uint8_t size2 = readUInt8C(crc);
-        readCharC((char *)_buffer, size2, crc);
-        std::string name((char *)_buffer, size2);
-        uint16_t finalCRC = readUInt16();
-        if (finalCRC == crc) {
-            //Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
-            //_storageService.context(&context);
-            //_datasetService.context(&context);
-            //_datasetService.updateMember(node, std::string(uuidDataset, 36), idUser, role, name);
-            writeUInt8(Codes::success);
-        } else {
-            writeUInt8(Codes::messageTransmissionError);
-        }
+        auto [uuidDataset, idUser, role, name] = MemberUpdate::read(*this);
+        //Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
+        //_storageService.context(&context);
+        //_datasetService.context(&context);
+        //_datasetService.updateMember(node, std::string(uuidDataset), (uint32_t)idUser, std::string(role), std::string(name));
+        writeUInt8(Codes::success);
     } catch (Services::NotExistsException &e) {
         writeUInt8(Codes::dataNotFound);
     } catch (Services::NotEnoughRightsException &e) {
@@ -526,21 +411,12 @@ void BinSyncHandlerIntance::updateMember(Services::Entities::Node &node) {
 
 void BinSyncHandlerIntance::deleteMember(Services::Entities::Node &node) {
     try {
-        uint16_t crc;
-        crc = 0x0000;
-        char uuidDataset[36];
-        readUUIDC(uuidDataset, crc);
-        uint32_t idUser = (uint32_t)readUInt64C(crc);
-        uint16_t finalCRC = readUInt16();
-        if (finalCRC == crc) {
-            //Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
-            //_storageService.context(&context);
-            //_datasetService.context(&context);
-            //_datasetService.removeMember(node, std::string(uuidDataset, 36), idUser);
-            writeUInt8(Codes::success);
-        } else {
-            writeUInt8(Codes::messageTransmissionError);
-        }
+        auto [uuidDataset, idUser] = MemberRequest::read(*this);
+        //Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
+        //_storageService.context(&context);
+        //_datasetService.context(&context);
+        //_datasetService.removeMember(node, std::string(uuidDataset), (uint32_t)idUser);
+        writeUInt8(Codes::success);
     } catch (Services::NotExistsException &e) {
         writeUInt8(Codes::dataNotFound);
     } catch (Services::NotEnoughRightsException &e) {
@@ -550,10 +426,43 @@ void BinSyncHandlerIntance::deleteMember(Services::Entities::Node &node) {
     }
 }
 
+// Subscribes the session to the data sets of the user, or cancels the
+// subscription. Notifications are sent as unsolicited 'a' frames, apart from
+// the reply to 'n', so they are only available with V2 framing.
+void BinSyncHandlerIntance::subscribe(Services::Entities::Node &node) {
+    auto [enable] = SubscriptionRequest::read(*this);
+    if (framing() != TCP::Framing::V2) {
+        writeUInt8(Codes::notSupported);
+        return;
+    }
+    if (_subscription) {
+        NotificationHub::unsubscribe(_subscription);
+        _subscription.reset();
+        idleTimeout(IdleTimeout);
+    }
+    if (enable) {
+        _subscription = std::make_shared<NotificationHub::Subscription>(wakeup());
+        Entities::User user = node.user();
+        DatasetService datasetService;
+        for (Entities::Dataset &dataset : datasetService.readDatasets(user, node.context()))
+            NotificationHub::subscribe(node.context(), dataset.uuid(), _subscription);
+        idleTimeout(SubscriptionTimeout);
+    }
+    writeUInt8(Codes::success);
+}
+
+void BinSyncHandlerIntance::deliver() {
+    for (auto &[uuidDataset, idHeader] : _subscription->take()) {
+        beginFrame(NotificationOperation, false);
+        Notification::write(*this, uuidDataset, idHeader);
+        endFrame();
+    }
+}
+
 void BinSyncHandlerIntance::fullSync(Services::Entities::Node &node) {
     uint8_t len8;
     uint16_t len16;
-    uint16_t crc;
+    uint32_t crc;
     uint8_t code;
     /*  _connection->commit();
   Services::Config::Context context = Services::SchemaService::getContextAndModuleUUID(node.context());
@@ -569,7 +478,7 @@ void BinSyncHandlerIntance::fullSync(Services::Entities::Node &node) {
     writeUUIDC(dataset.uuid().c_str(), crc);
     datasetsMap.emplace(dataset.uuid(), dataset);
   }
-  writeUInt16(crc);
+  writeChecksum(crc);
   code = readUInt8();
   while (code == Codes::newContainerAvailable) {
     crc = 0x0000;
@@ -577,7 +486,7 @@ void BinSyncHandlerIntance::fullSync(Services::Entities::Node &node) {
     readUUIDC(uuidDataset, crc);
     uint32_t idHeader = readUInt32C(crc);
     uint8_t status = readUInt8C(crc);
-    uint16_t finalCRC = readUInt16();
+    uint32_t finalCRC = readChecksum();
     if (status == 2) {
       Services::Entities::Dataset dataset = _datasetService.addDataset(node.user(), std::string(uuidDataset, 36));
       datasets.push_back(dataset);
@@ -608,7 +517,7 @@ void BinSyncHandlerIntance::fullSync(Services::Entities::Node &node) {
         len8 = readUInt8C(crc);
         readCharC((char*) _buffer, len8, crc);
         std::string role((char*) _buffer, len8);
-        uint16_t finalCRC = readUInt16();
+        uint32_t finalCRC = readChecksum();
         if (finalCRC == crc) {
           _datasetService.putDataset(node, datasetPtr->second, email, name, role);
         } else {
@@ -619,8 +528,11 @@ void BinSyncHandlerIntance::fullSync(Services::Entities::Node &node) {
     }
     code = readUInt8();
     if (code == Codes::newGroupAvailable) {
+      Memory::Arena arena;
       while (code == Codes::newGroupAvailable) {
         Services::Entities::Header header;
+        arena.reset();
+        header.arena(&arena);
         crc = 0x0000;
         header.idDataset(datasetPtr->second.id());
         header.node(node.id());
@@ -632,28 +544,34 @@ void BinSyncHandlerIntance::fullSync(Services::Entities::Node &node) {
         header.version(readUInt32C(crc));
         code = readUInt8();
         while (code == Codes::newElementAvailable) {
-          Services::Entities::Change change;
+          Services::Entities::ChangeView change;
+          char *ptr;
           change.idChange(readUInt16C(crc));
           change.operation(readUInt8C(crc));
           len8 = readUInt8C(crc);
-          readCharC((char*) _buffer, len8, crc);
-          change.entityName(std::string((char*) _buffer, len8));
+          ptr = arena.allocate(len8);
+          readCharC(ptr, len8, crc);
+          change.entityName(std::string_view(ptr, len8));
           len8 = readUInt8C(crc);
-          readCharC((char*) _buffer, len8, crc);
-          change.newPK(std::string((char*) _buffer, len8));
+          ptr = arena.allocate(len8);
+          readCharC(ptr, len8, crc);
+          change.newPK(std::string_view(ptr, len8));
           len8 = readUInt8C(crc);
-          readCharC((char*) _buffer, len8, crc);
-          change.oldPK(std::string((char*) _buffer, len8));
+          ptr = arena.allocate(len8);
+          readCharC(ptr, len8, crc);
+          change.oldPK(std::string_view(ptr, len8));
           len16 = readUInt16C(crc, 32767);
-          readCharC((char*) _buffer, len16, crc);
-          change.newData(std::string((char*) _buffer, len16));
+          ptr = arena.allocate(len16);
+          readCharC(ptr, len16, crc);
+          change.newData(std::string_view(ptr, len16));
           len16 = readUInt16C(crc, 32767);
-          readCharC((char*) _buffer, len16, crc);
-          change.oldData(std::string((char*) _buffer, len16));
-          header.changes().push_back(std::move(change));
+          ptr = arena.allocate(len16);
+          readCharC(ptr, len16, crc);
+          change.oldData(std::string_view(ptr, len16));
+          header.changes().push_back(change);
           code = readUInt8();
         }
-        uint16_t finalCRC = readUInt16();
+        uint32_t finalCRC = readChecksum();
         if (finalCRC == crc) {
           if (isMember && readed.second < header.idNode())
             _storageService.saveHeader(node, header, idHeader);
@@ -708,7 +626,7 @@ void BinSyncHandlerIntance::fullSync(Services::Entities::Node &node) {
       writeUInt16C(p.number(), crc);
     }
     writeUInt8(Codes::success);
-    writeUInt16(crc);
+    writeChecksum(crc);
     std::pair<uint32_t, uint32_t> lastSynchronizedId = _storageService.readLastSynchronizedId(node, dataset.id());
     if (lastSynchronizedId.first == 0 && lastSynchronizedId.second == 0) {
       try {
@@ -731,7 +649,7 @@ void BinSyncHandlerIntance::fullSync(Services::Entities::Node &node) {
               writeCharC(change.newData().data(), change.newData().size(), crc);
               writeUInt16C(change.oldData().size(), crc);
               writeCharC(change.oldData().data(), change.oldData().size(), crc);
-              writeUInt16(crc);
+              writeChecksum(crc);
             }
           }
         }
@@ -782,7 +700,7 @@ void BinSyncHandlerIntance::fullSync(Services::Entities::Node &node) {
                 writeCharC(change.oldData().data(), change.oldData().size(), crc);
               }
               writeUInt8(Codes::success);
-              writeUInt16(crc);
+              writeChecksum(crc);
             }
           }
         }
@@ -0,0 +1,98 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <services/NotificationHub.hpp>
+
+#include <algorithm>
+
+namespace Beehive {
+namespace Services {
+
+std::mutex NotificationHub::_mutex;
+std::unordered_map<std::string, std::vector<std::weak_ptr<NotificationHub::Subscription>>> NotificationHub::_subscriptions;
+
+std::unordered_map<std::string, uint32_t> NotificationHub::Subscription::take() {
+    std::unordered_map<std::string, uint32_t> pending;
+    std::lock_guard<std::mutex> lock(_mutex);
+    pending.swap(_pending);
+    return pending;
+}
+
+void NotificationHub::Subscription::post(const std::string &uuidDataset, uint32_t idHeader) {
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        wake = _pending.empty();
+        uint32_t &pending = _pending[uuidDataset];
+        pending = std::max(pending, idHeader);
+    }
+    if (wake && _wake)
+        _wake();
+}
+
+void NotificationHub::subscribe(const std::string &context, const std::string &uuidDataset, const std::shared_ptr<Subscription> &subscription) {
+    std::string subscriptionKey = key(context, uuidDataset);
+    std::lock_guard<std::mutex> lock(_mutex);
+    _subscriptions[subscriptionKey].push_back(subscription);
+    subscription->_keys.push_back(std::move(subscriptionKey));
+}
+
+void NotificationHub::unsubscribe(const std::shared_ptr<Subscription> &subscription) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const std::string &subscriptionKey : subscription->_keys) {
+        auto subscriptionsPtr = _subscriptions.find(subscriptionKey);
+        if (subscriptionsPtr == _subscriptions.end())
+            continue;
+        std::vector<std::weak_ptr<Subscription>> &subscriptions = subscriptionsPtr->second;
+        subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(), [&](const std::weak_ptr<Subscription> &other) {
+            std::shared_ptr<Subscription> locked = other.lock();
+            return !locked || locked == subscription;
+        }), subscriptions.end());
+        if (subscriptions.empty())
+            _subscriptions.erase(subscriptionsPtr);
+    }
+    subscription->_keys.clear();
+}
+
+void NotificationHub::publish(const std::string &context, const std::string &uuidDataset, uint32_t idHeader) {
+    std::vector<std::shared_ptr<Subscription>> subscriptions;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto subscriptionsPtr = _subscriptions.find(key(context, uuidDataset));
+        if (subscriptionsPtr == _subscriptions.end())
+            return;
+        for (const std::weak_ptr<Subscription> &subscription : subscriptionsPtr->second) {
+            if (std::shared_ptr<Subscription> locked = subscription.lock())
+                subscriptions.push_back(std::move(locked));
+        }
+    }
+    for (std::shared_ptr<Subscription> &subscription : subscriptions)
+        subscription->post(uuidDataset, idHeader);
+}
+
+} /* namespace Services */
+} /* namespace Beehive */
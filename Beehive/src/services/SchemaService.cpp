@@ -32,6 +32,7 @@ SOFTWARE.
 #include <json/json.hpp>
 #include <nanolog/NanoLog.hpp>
 #include <regex>
+#include <services/ContextRegistry.hpp>
 #include <services/SchemaService.hpp>
 #include <services/ServiceException.hpp>
 #include <sstream>
@@ -75,11 +76,13 @@ std::string SchemaService::putContext(const std::string &body) {
     nlohmann::to_json(storeJson, context);
     std::string contextBody = storeJson.dump();
     DAO::Storage::putValue("Schema", contextBody, context.uuid);
+    ContextRegistry::invalidate(context.uuid);
     return contextBody;
 }
 
 void SchemaService::deleteContext(const std::string &uuid) {
     DAO::Storage::deleteContext(uuid);
+    ContextRegistry::invalidate(uuid);
 }
 
 void SchemaService::linkContext(const std::string &context, const std::string &link) {
@@ -89,9 +92,11 @@ void SchemaService::linkContext(const std::string &context, const std::string &l
         std::string version = match[2];
         if(0 < std::stoi(version)) {
             std::string contextBody;
-            if (!DAO::Storage::getValue("Schema", &contextBody, context))
+            DAO::Storage::ContextHandle handle = DAO::Storage::handle(context);
+            if (!DAO::Storage::getValue("Schema", &contextBody, handle))
                 throw StorageErrorException("Context " + context + " was not found.");
-            DAO::Storage::putValue("Schema." + version, contextBody, context);
+            DAO::Storage::putValue("Schema." + version, contextBody, handle);
+            ContextRegistry::invalidate(context);
         } else {
             throw InvalidRequestException("Version must be greater than 0.");
         }
@@ -106,17 +111,16 @@ void SchemaService::unlinkContext(const std::string &context, const std::string
     if (std::regex_match(link, match, exp) && match.size() == 3 && context == match[1]) {
         std::string version = match[2];
         DAO::Storage::deleteValue("Schema." + version, context);
+        ContextRegistry::invalidate(context);
     } else {
         throw InvalidRequestException("Link header is not valid");
     }
 }
 
 std::string SchemaService::getLinkedVersions(const std::string &context) {
-    std::vector<std::pair<std::string, std::string>> values;
-    DAO::Storage::getValues("Schema.", values, context);
     std::vector<std::string> versions;
-    for(auto value: values)
-        versions.push_back(value.first.substr(7));
+    for (DAO::Storage::Scan scan = DAO::Storage::scan("Schema.", context); scan.valid(); scan.next())
+        versions.emplace_back(scan.key().data() + 7, scan.key().size() - 7);
     nlohmann::json storeJson = versions;
     std::string contextBody = storeJson.dump();
     return contextBody;
@@ -124,8 +128,9 @@ std::string SchemaService::getLinkedVersions(const std::string &context) {
 
 std::string SchemaService::getLinkedVersion(const std::string &context, const std::string &version) {
     std::string contextBody;
-    if (!DAO::Storage::getValue("Schema." + version, &contextBody, context)) {
-        if (!DAO::Storage::getValue("Schema", &contextBody, context))
+    DAO::Storage::ContextHandle handle = DAO::Storage::handle(context);
+    if (!DAO::Storage::getValue("Schema." + version, &contextBody, handle)) {
+        if (!DAO::Storage::getValue("Schema", &contextBody, handle))
             throw StorageErrorException("Schema of context " + context + " was not found.");
         nlohmann::json bodyJson = nlohmann::json::parse(contextBody);
         Config::Context ctx;
@@ -27,6 +27,7 @@ SOFTWARE.
 
 #include <services/StorageService.hpp>
 
+#include <services/NotificationHub.hpp>
 #include <services/ServiceException.hpp>
 #include <exprtk/exprtk.hpp>
 
@@ -34,37 +35,18 @@ SOFTWARE.
 #include <sqlite/TextDecoder.hpp>
 #include <sqlite/TextEncoder.hpp>
 #include <sqlite/BinaryEncoder.hpp>
+#include <validation/ValidationBatch.hpp>
 #include <uuid/uuid.h>
+#include <memory_resource>
 #include <unordered_map>
 
 namespace Beehive {
 namespace Services {
 
-void StorageService::context(Config::Context *context) {
-  _context = context;
-  try {
-    for (auto &transaction : _context->transactions) {
-      if (transaction.second.pre != "")
-        _transactionsManager.loadValidation(transaction.second.uuid, transaction.second.pre);
-      if (transaction.second.post != "")
-        _transactionsManager.loadCommit(transaction.second.uuid, transaction.second.post);
-    }
-
-    for (auto &entity : _context->entities) {
-      for (auto &attribute : entity.second.attributes) {
-        if (attribute.second.check && (attribute.second.type == SqLite::AttributeType::Integer || attribute.second.type == SqLite::AttributeType::Real || attribute.second.type == SqLite::AttributeType::Text)) {
-          attribute.second.validator = std::make_shared<Utils::Validator>(attribute.second.name, *attribute.second.check, attribute.second.type);
-        }
-      }
-    }
-
-    _transactionsManager.context(_context);
-    _transactionsManager.entityDAO(&_entityDAO);
-
-  } catch (std::exception &e) {
-    LOG_ERROR << e.what();
-  }
-
+void StorageService::context(std::shared_ptr<Config::Context> context) {
+  _context = std::move(context);
+  _transactionsManager.context(_context);
+  _transactionsManager.entityDAO(&_entityDAO);
 }
 
 bool StorageService::isMember(Entities::Node &node, uint32_t idDataset) {
@@ -77,29 +59,39 @@ StorageService::EntityReader StorageService::readEntityData(Entities::Node &node
 }
 
 std::vector<Entities::Header> StorageService::readHeaders(Entities::Node &node, uint32_t idDataset, uint32_t idHeader) {
-  return _headerDAO.readFrom(idDataset, idHeader, _context->uuid);
+  return _headerDAO.readFrom(idDataset, idHeader, DAO::Storage::handle(_context->uuid));
 }
 
 std::vector<Entities::Change> StorageService::readChanges(Entities::Node &node, uint32_t idDataset, uint32_t idHeader, std::unordered_map<std::string, Config::Entity, Utils::IHasher, Utils::IEqualsComparator> &entities, const std::unordered_map<std::string, std::unordered_set<int>> &entitiesByNode) {
-  return _changeDAO.readByHeader(idDataset, idHeader, entities, entitiesByNode, _context->uuid);
+  DAO::Storage::ContextHandle context = DAO::Storage::handle(_context->uuid);
+  return _changeDAO.readByHeader(idDataset, idHeader, entities, entitiesByNode, context);
+}
+
+bool parseUUID(std::string_view text, uuid_t uuid) {
+  char buffer[37];
+  if (text.size() != 36)
+    return false;
+  text.copy(buffer, 36);
+  buffer[36] = '\0';
+  return uuid_parse(buffer, uuid) == 0;
 }
 
 void printValue(SqLite::TextDecoder::Value &value) {
   switch (value.type()) {
   case SqLite::AttributeType::Integer:
-    LOG_DEBUG << "Attribute: " << value.column() << " Integer: " << value.integerValue();
+    LOG_DEBUG << "Attribute: " << std::string(value.column()) << " Integer: " << value.integerValue();
     break;
   case SqLite::AttributeType::Real:
-    LOG_DEBUG << "Attribute: " << value.column() << " Real: " << value.realValue();
+    LOG_DEBUG << "Attribute: " << std::string(value.column()) << " Real: " << value.realValue();
     break;
   case SqLite::AttributeType::Text:
-    LOG_DEBUG << "Attribute: " << value.column() << " Text: " << value.textValue();
+    LOG_DEBUG << "Attribute: " << std::string(value.column()) << " Text: " << std::string(value.textValue());
     break;
   case SqLite::AttributeType::Blob:
-    LOG_DEBUG << "Attribute: " << value.column() << " Blob: {}";
+    LOG_DEBUG << "Attribute: " << std::string(value.column()) << " Blob: {}";
     break;
   case SqLite::AttributeType::Null:
-    LOG_DEBUG << "Attribute: " << value.column() << " Null ";
+    LOG_DEBUG << "Attribute: " << std::string(value.column()) << " Null ";
     break;
   }
 }
@@ -114,16 +106,18 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
       throw SchemaDefinitionException("Transaction not found '" + header.transactionName() + "', the transaction will be rolled back.");
     }
     header.transactionUUID(transactionMapPtr->second);
-    for (Entities::Change &change : header.changes()) {
-      auto entityMapPtr = _context->entitiesName2UUID.find(change.entityName());
+    Memory::Arena &arena = *header.arena();
+    Utils::ValidationBatch batch(arena.resource());
+    for (Entities::ChangeView &change : header.changes()) {
+      auto entityMapPtr = _context->entitiesName2UUID.find(std::string(change.entityName()));
       if (entityMapPtr == _context->entitiesName2UUID.end()) {
-        LOG_WARN << "Entity '" + change.entityName() + "' not defined, it will be ignored.";
+        LOG_WARN << "Entity '" + std::string(change.entityName()) + "' not defined, it will be ignored.";
         continue;
       }
       change.entityUUID(entityMapPtr->second);
       auto entityPtr = _context->entities.find(change.entityUUID());
       if (entityPtr == _context->entities.end()) {
-        LOG_WARN << "Entity '" + change.entityName() + "' not defined, it will be ignored.";
+        LOG_WARN << "Entity '" + std::string(change.entityName()) + "' not defined, it will be ignored.";
         continue;
       }
       const Config::Entity &entity = entityPtr->second;
@@ -135,20 +129,20 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
       case SqLite::Operation::Insert: {
         if (!transactionPtr->second.add)
           throw OperationNotAllowedException("Transaction '" + transactionPtr->second.name + "' can't insert '" + entity.name + "', the transaction will be rolled back.");
-        SqLite::TextDecoder newPK(change.newPK().data(), change.newPK().size(), entity.keysName2Id, entity.name);
-        SqLite::TextDecoder newData(change.newData().data(), change.newData().size(), entity.attributesName2Id, entity.name);
-        SqLite::BinaryEncoder newBinaryPK;
-        SqLite::BinaryEncoder newBinaryData;
-        std::unordered_map<int, bool> usedKeys;
-        std::unordered_map<int, bool> usedAttribites;
-        LOG_DEBUG << "Insert on " << change.entityName();
+        SqLite::TextDecoder newPK(change.newPK().data(), change.newPK().size(), entity.keysCodec, entity.name);
+        SqLite::TextDecoder newData(change.newData().data(), change.newData().size(), entity.attributesCodec, entity.name);
+        SqLite::BinaryEncoder newBinaryPK(arena.resource());
+        SqLite::BinaryEncoder newBinaryData(arena.resource());
+        std::pmr::unordered_map<int, bool> usedKeys(arena.resource());
+        std::pmr::unordered_map<int, bool> usedAttribites(arena.resource());
+        LOG_DEBUG << "Insert on " << std::string(change.entityName());
         LOG_DEBUG << "New primary key";
         for (SqLite::TextDecoder::Value &value : newPK) {
           printValue(value);
           int id = value.id();
           auto keyPtr = entity.keys.find(id);
           if (keyPtr == entity.keys.end())
-            throw SchemaDefinitionException("Key attribute not found '" + entity.name + "." + value.column() + "', the transaction will be rolled back.");
+            throw SchemaDefinitionException("Key attribute not found '" + entity.name + "." + std::string(value.column()) + "', the transaction will be rolled back.");
           const Config::Entity::Key &key = keyPtr->second;
           if (value.type() == SqLite::AttributeType::Null)
             throw DataValidationException("Key attribute '" + entity.name + "." + keyPtr->second.name + "' can't be null, the transaction will be rolled back.");
@@ -156,7 +150,7 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
             throw DataValidationException("Invalid data type for key attribute '" + entity.name + "." + keyPtr->second.name + "', the transaction will be rolled back.");
           if (key.type == SqLite::AttributeType::UuidV1 || key.type == SqLite::AttributeType::UuidV4) {
             uuid_t uuid;
-            if (uuid_parse(value.textValue().c_str(), uuid) != 0)
+            if (!parseUUID(value.textValue(), uuid))
               throw DataValidationException("Invalid data value for key attribute '" + entity.name + "." + keyPtr->second.name + "', the transaction will be rolled back.");
             if (key.type == SqLite::AttributeType::UuidV1 && uuid_type(uuid) != UUID_TYPE_DCE_TIME)
               throw DataValidationException("Invalid data value for uuid key attribute '" + entity.name + "." + keyPtr->second.name + "', the transaction will be rolled back.");
@@ -172,7 +166,7 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
           int id = value.id();
           auto attributePtr = entity.attributes.find(id);
           if (attributePtr == entity.attributes.end()) {
-            LOG_WARN << "Attribute '" + entity.name + "." + attributePtr->second.name + "' not defined, it will be ignored.";
+            LOG_WARN << "Attribute '" + entity.name + "." + std::string(value.column()) + "' not defined, it will be ignored.";
             continue;
           }
           const Config::Entity::Attribute &attribute = attributePtr->second;
@@ -182,11 +176,11 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
             throw DataValidationException("Invalid data type for attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
           if (attribute.type == SqLite::AttributeType::UuidV1 || attribute.type == SqLite::AttributeType::UuidV4) {
             uuid_t uuid;
-            if (uuid_parse(value.textValue().c_str(), uuid) != 0)
+            if (!parseUUID(value.textValue(), uuid))
               throw DataValidationException("Invalid data value for attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
             if (attribute.type == SqLite::AttributeType::UuidV1 && uuid_type(uuid) != UUID_TYPE_DCE_TIME)
               throw DataValidationException("Invalid data value for uuid attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
-            newBinaryData.addUUID(id, std::string((char*) uuid, 16));
+            newBinaryData.addUUID(id, std::string_view((char*) uuid, 16));
           } else {
             newBinaryData.addValue(value);
           }
@@ -194,16 +188,12 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
             throw DataValidationException("Duplicated value for attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
           usedAttribites.emplace(attribute.id, true);
           if (attributePtr->second.validator) {
-            if (attribute.type == SqLite::AttributeType::Integer) {
-              if (!attributePtr->second.validator->isValidValue(value.integerValue()))
-                throw DataValidationException("Not valid value[" + std::to_string(value.integerValue()) + "] for attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
-            } else if (attribute.type == SqLite::AttributeType::Real) {
-              if (!attributePtr->second.validator->isValidValue(value.realValue()))
-                throw DataValidationException("Not valid value[" + std::to_string(value.realValue()) + "] for attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
-            } else if (attribute.type == SqLite::AttributeType::Text) {
-              if (!attributePtr->second.validator->isValidValue(value.textValue()))
-                throw DataValidationException("Not valid value [" + value.textValue() + "] for attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
-            }
+            if (attribute.type == SqLite::AttributeType::Integer)
+              batch.add(attributePtr->second.validator.get(), entity.name, attribute.name, value.integerValue());
+            else if (attribute.type == SqLite::AttributeType::Real)
+              batch.add(attributePtr->second.validator.get(), entity.name, attribute.name, value.realValue());
+            else if (attribute.type == SqLite::AttributeType::Text)
+              batch.add(attributePtr->second.validator.get(), entity.name, attribute.name, value.textValue());
           }
         }
         for (auto &key : entity.keys) {
@@ -214,29 +204,29 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
           if (attribute.second.notnull && usedAttribites.find(attribute.second.id) == usedAttribites.end())
             throw DataValidationException("Not null attribute '" + entity.name + "." + attribute.second.name + "' missing on insert, the transaction will be rolled back.");
         }
-        change.newPK(newBinaryPK.encodedData());
-        change.newData(newBinaryData.encodedData());
+        change.newPK(newBinaryPK.encodedData(arena));
+        change.newData(newBinaryData.encodedData(arena));
       }
         break;
       case SqLite::Operation::Update: {
         if (transactionPtr->second.update.empty())
           throw OperationNotAllowedException("Transaction '" + transactionPtr->second.name + "' can't update '" + entity.name + "', the transaction will be rolled back.");
-        SqLite::TextDecoder newPK(change.newPK().data(), change.newPK().size(), entity.keysName2Id, entity.name);
-        SqLite::TextDecoder newData(change.newData().data(), change.newData().size(), entity.attributesName2Id, entity.name);
-        SqLite::TextDecoder oldPK(change.oldPK().data(), change.oldPK().size(), entity.keysName2Id, entity.name);
-        SqLite::TextDecoder oldData(change.oldData().data(), change.oldData().size(), entity.attributesName2Id, entity.name);
-        SqLite::BinaryEncoder newBinaryPK;
-        SqLite::BinaryEncoder newBinaryData;
-        SqLite::BinaryEncoder oldBinaryPK;
-        SqLite::BinaryEncoder oldBinaryData;
-        LOG_DEBUG << "Update on " << change.entityName();
+        SqLite::TextDecoder newPK(change.newPK().data(), change.newPK().size(), entity.keysCodec, entity.name);
+        SqLite::TextDecoder newData(change.newData().data(), change.newData().size(), entity.attributesCodec, entity.name);
+        SqLite::TextDecoder oldPK(change.oldPK().data(), change.oldPK().size(), entity.keysCodec, entity.name);
+        SqLite::TextDecoder oldData(change.oldData().data(), change.oldData().size(), entity.attributesCodec, entity.name);
+        SqLite::BinaryEncoder newBinaryPK(arena.resource());
+        SqLite::BinaryEncoder newBinaryData(arena.resource());
+        SqLite::BinaryEncoder oldBinaryPK(arena.resource());
+        SqLite::BinaryEncoder oldBinaryData(arena.resource());
+        LOG_DEBUG << "Update on " << std::string(change.entityName());
         LOG_DEBUG << "New primary key";
         for (SqLite::TextDecoder::Value &value : newPK) {
           printValue(value);
           int id = value.id();
           auto keyPtr = entity.keys.find(id);
           if (keyPtr == entity.keys.end())
-            throw SchemaDefinitionException("Key attribute not found '" + entity.name + "." + value.column() + "', the transaction will be rolled back.");
+            throw SchemaDefinitionException("Key attribute not found '" + entity.name + "." + std::string(value.column()) + "', the transaction will be rolled back.");
           const Config::Entity::Key &key = keyPtr->second;
           if (value.type() == SqLite::AttributeType::Null)
             throw DataValidationException("Key attribute '" + entity.name + "." + keyPtr->second.name + "' can't be null, the transaction will be rolled back.");
@@ -244,7 +234,7 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
             throw DataValidationException("Invalid data type for key attribute '" + entity.name + "." + keyPtr->second.name + "', the transaction will be rolled back.");
           if (key.type == SqLite::AttributeType::UuidV1 || key.type == SqLite::AttributeType::UuidV4) {
             uuid_t uuid;
-            if (uuid_parse(value.textValue().c_str(), uuid) != 0)
+            if (!parseUUID(value.textValue(), uuid))
               throw DataValidationException("Invalid data value for key attribute '" + entity.name + "." + keyPtr->second.name + "', the transaction will be rolled back.");
             if (key.type == SqLite::AttributeType::UuidV1 && uuid_type(uuid) != UUID_TYPE_DCE_TIME)
               throw DataValidationException("Invalid data value for uuid key attribute '" + entity.name + "." + keyPtr->second.name + "', the transaction will be rolled back.");
@@ -257,11 +247,11 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
           int id = value.id();
           auto attributePtr = entity.attributes.find(id);
           if (attributePtr == entity.attributes.end()) {
-            LOG_WARN << "Attribute '" + entity.name + "." + attributePtr->second.name + "' not defined, it will be ignored.";
+            LOG_WARN << "Attribute '" + entity.name + "." + std::string(value.column()) + "' not defined, it will be ignored.";
             continue;
           }
           if (transactionPtr->second.update.find(id) == transactionPtr->second.update.end())
-            throw DataValidationException("Transaction '" + transactionPtr->second.name + "' can't update attribute '" + entity.name + "." + value.column() + "', the transaction will be rolled back.");
+            throw DataValidationException("Transaction '" + transactionPtr->second.name + "' can't update attribute '" + entity.name + "." + std::string(value.column()) + "', the transaction will be rolled back.");
           const Config::Entity::Attribute &attribute = attributePtr->second;
           if (attribute.notnull && value.type() == SqLite::AttributeType::Null)
             throw DataValidationException("Attribute '" + entity.name + "." + attributePtr->second.name + "' can't be null, the transaction will be rolled back.");
@@ -269,25 +259,21 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
             throw DataValidationException("Invalid data type for attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
           if (attribute.type == SqLite::AttributeType::UuidV1 || attribute.type == SqLite::AttributeType::UuidV4) {
             uuid_t uuid;
-            if (uuid_parse(value.textValue().c_str(), uuid) != 0)
+            if (!parseUUID(value.textValue(), uuid))
               throw DataValidationException("Invalid data value for attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
             if (attribute.type == SqLite::AttributeType::UuidV1 && uuid_type(uuid) != UUID_TYPE_DCE_TIME)
               throw DataValidationException("Invalid data value for uuid attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
-            newBinaryData.addUUID(id, std::string((char*) uuid, 16));
+            newBinaryData.addUUID(id, std::string_view((char*) uuid, 16));
           } else {
             newBinaryData.addValue(value);
           }
           if (attributePtr->second.validator) {
-            if (attribute.type == SqLite::AttributeType::Integer) {
-              if (!attributePtr->second.validator->isValidValue(value.integerValue()))
-                throw DataValidationException("Not valid value[" + std::to_string(value.integerValue()) + "] for attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
-            } else if (attribute.type == SqLite::AttributeType::Real) {
-              if (!attributePtr->second.validator->isValidValue(value.realValue()))
-                throw DataValidationException("Not valid value[" + std::to_string(value.realValue()) + "] for attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
-            } else if (attribute.type == SqLite::AttributeType::Text) {
-              if (!attributePtr->second.validator->isValidValue(value.textValue()))
-                throw DataValidationException("Not valid value [" + value.textValue() + "] for attribute '" + entity.name + "." + attributePtr->second.name + "', the transaction will be rolled back.");
-            }
+            if (attribute.type == SqLite::AttributeType::Integer)
+              batch.add(attributePtr->second.validator.get(), entity.name, attribute.name, value.integerValue());
+            else if (attribute.type == SqLite::AttributeType::Real)
+              batch.add(attributePtr->second.validator.get(), entity.name, attribute.name, value.realValue());
+            else if (attribute.type == SqLite::AttributeType::Text)
+              batch.add(attributePtr->second.validator.get(), entity.name, attribute.name, value.textValue());
           }
         }
         LOG_DEBUG << "Old primary key";
@@ -296,7 +282,7 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
           int id = value.id();
           auto keyPtr = entity.keys.find(id);
           if (keyPtr == entity.keys.end())
-            throw SchemaDefinitionException("Key attribute not found '" + entity.name + "." + value.column() + "', the transaction will be rolled back.");
+            throw SchemaDefinitionException("Key attribute not found '" + entity.name + "." + std::string(value.column()) + "', the transaction will be rolled back.");
           const Config::Entity::Key &key = keyPtr->second;
           if (value.type() == SqLite::AttributeType::Null)
             throw DataValidationException("Key attribute '" + entity.name + "." + keyPtr->second.name + "' can't be null, the transaction will be rolled back.");
@@ -304,7 +290,7 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
             throw DataValidationException("Invalid data type for key attribute '" + entity.name + "." + keyPtr->second.name + "', the transaction will be rolled back.");
           if (key.type == SqLite::AttributeType::UuidV1 || key.type == SqLite::AttributeType::UuidV4) {
             uuid_t uuid;
-            if (uuid_parse(value.textValue().c_str(), uuid) != 0)
+            if (!parseUUID(value.textValue(), uuid))
               throw DataValidationException("Invalid data value for key attribute '" + entity.name + "." + keyPtr->second.name + "', the transaction will be rolled back.");
             if (key.type == SqLite::AttributeType::UuidV1 && uuid_type(uuid) != UUID_TYPE_DCE_TIME)
               throw DataValidationException("Invalid data value for uuid key attribute '" + entity.name + "." + keyPtr->second.name + "', the transaction will be rolled back.");
@@ -316,27 +302,27 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
           printValue(value);
           oldBinaryData.addValue(value);
         }
-        change.newPK(newBinaryPK.encodedData());
-        change.newData(newBinaryData.encodedData());
-        change.oldPK(oldBinaryPK.encodedData());
-        change.oldData(oldBinaryData.encodedData());
+        change.newPK(newBinaryPK.encodedData(arena));
+        change.newData(newBinaryData.encodedData(arena));
+        change.oldPK(oldBinaryPK.encodedData(arena));
+        change.oldData(oldBinaryData.encodedData(arena));
       }
         break;
       case SqLite::Operation::Delete: {
         if (!transactionPtr->second.remove)
           throw OperationNotAllowedException("Transaction '" + transactionPtr->second.name + "' can't delete '" + entity.name + "', the transaction will be rolled back.");
-        SqLite::TextDecoder oldPK(change.oldPK().data(), change.oldPK().size(), entity.keysName2Id, entity.name);
-        SqLite::TextDecoder oldData(change.oldData().data(), change.oldData().size(), entity.attributesName2Id, entity.name);
-        SqLite::BinaryEncoder oldBinaryPK;
-        SqLite::BinaryEncoder oldBinaryData;
-        LOG_DEBUG << "Delete on " << change.entityName();
+        SqLite::TextDecoder oldPK(change.oldPK().data(), change.oldPK().size(), entity.keysCodec, entity.name);
+        SqLite::TextDecoder oldData(change.oldData().data(), change.oldData().size(), entity.attributesCodec, entity.name);
+        SqLite::BinaryEncoder oldBinaryPK(arena.resource());
+        SqLite::BinaryEncoder oldBinaryData(arena.resource());
+        LOG_DEBUG << "Delete on " << std::string(change.entityName());
         LOG_DEBUG << "Old primary key";
         for (SqLite::TextDecoder::Value &value : oldPK) {
           printValue(value);
           int id = value.id();
           auto keyPtr = entity.keys.find(id);
           if (keyPtr == entity.keys.end())
-            throw SchemaDefinitionException("Key attribute not found '" + entity.name + "." + value.column() + "', the transaction will be rolled back.");
+            throw SchemaDefinitionException("Key attribute not found '" + entity.name + "." + std::string(value.column()) + "', the transaction will be rolled back.");
           const Config::Entity::Key &key = keyPtr->second;
           if (value.type() == SqLite::AttributeType::Null)
             throw DataValidationException("Key attribute '" + entity.name + "." + keyPtr->second.name + "' can't be null, the transaction will be rolled back.");
@@ -344,7 +330,7 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
             throw DataValidationException("Invalid data type for key attribute '" + entity.name + "." + keyPtr->second.name + "', the transaction will be rolled back.");
           if (key.type == SqLite::AttributeType::UuidV1 || key.type == SqLite::AttributeType::UuidV4) {
             uuid_t uuid;
-            if (uuid_parse(value.textValue().c_str(), uuid) != 0)
+            if (!parseUUID(value.textValue(), uuid))
               throw DataValidationException("Invalid data value for key attribute '" + entity.name + "." + keyPtr->second.name + "', the transaction will be rolled back.");
             if (key.type == SqLite::AttributeType::UuidV1 && uuid_type(uuid) != UUID_TYPE_DCE_TIME)
               throw DataValidationException("Invalid data value for uuid key attribute '" + entity.name + "." + keyPtr->second.name + "', the transaction will be rolled back.");
@@ -356,12 +342,13 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
           printValue(value);
           oldBinaryData.addValue(value);
         }
-        change.oldPK(oldBinaryPK.encodedData());
-        change.oldData(oldBinaryData.encodedData());
+        change.oldPK(oldBinaryPK.encodedData(arena));
+        change.oldData(oldBinaryData.encodedData(arena));
       }
         break;
       }
     }
+    batch.validate();
   } catch (Services::DataValidationException &e) {
     LOG_WARN << e.what();
     return ValidationCodes::notValidIncomeData;
@@ -378,9 +365,9 @@ StorageService::ValidationCodes StorageService::checkHeaderAndTransform(Entities
   return ValidationCodes::success;
 }
 
-StorageService::ValidationCodes StorageService::applyChange(Entities::Node &node, Entities::Header &header, Entities::Change &change) {
+StorageService::ValidationCodes StorageService::applyChange(Entities::Node &node, Entities::Header &header, Entities::ChangeView &change, const DAO::Storage::ContextHandle &context, DAO::Storage::Batch &batch) {
   try {
-    auto entityMapPtr = _context->entitiesName2UUID.find(change.entityName());
+    auto entityMapPtr = _context->entitiesName2UUID.find(std::string(change.entityName()));
     if (entityMapPtr == _context->entitiesName2UUID.end()) {
       return ValidationCodes::skipEntity;
     }
@@ -389,27 +376,28 @@ StorageService::ValidationCodes StorageService::applyChange(Entities::Node &node
       return ValidationCodes::skipEntity;
     }
     const Config::Entity &entity = entityPtr->second;
+    Memory::Arena &arena = *header.arena();
     switch (change.operation()) {
     case SqLite::Operation::Insert: {
-        _entityDAO.save(change, entity, _context->uuid);
+        _entityDAO.save(change, entity, context, batch);
     }
       break;
     case SqLite::Operation::Update: {
-      Entities::KeyData keyData = _entityDAO.read(change, entity, _context->uuid);
+      Entities::KeyData keyData = _entityDAO.read(change, entity, context);
       SqLite::BinaryDecoder oldDecoder(keyData.oldData().data(), keyData.oldData().size());
       SqLite::BinaryDecoder newDecoder(change.newData().data(), change.newData().size());
-      SqLite::BinaryEncoder encoder;
+      SqLite::BinaryEncoder encoder(arena.resource());
       for (SqLite::BinaryDecoder::Value &value : oldDecoder)
         encoder.addValue(value);
       for (SqLite::BinaryDecoder::Value &value : newDecoder)
         encoder.addValue(value);
-      change.newData(encoder.encodedData());
-      if (_entityDAO.update(change, entity, _context->uuid) != 1)
+      change.newData(encoder.encodedData(arena));
+      if (_entityDAO.update(change, entity, context, batch) != 1)
         return ValidationCodes::entityNotFound;
     }
       break;
     case SqLite::Operation::Delete: {
-      if (_entityDAO.remove(change, entity, _context->uuid) != 1)
+      if (_entityDAO.remove(change, entity, context, batch) != 1)
         return ValidationCodes::entityNotFound;
     }
       break;
@@ -422,32 +410,35 @@ StorageService::ValidationCodes StorageService::applyChange(Entities::Node &node
 }
 
 std::pair<uint32_t, uint32_t> StorageService::readLastSynchronizedId(Entities::Node &node, uint32_t idDataset) {
-  return _downloadedDAO.read(node.uuid(), idDataset, _context->uuid);
+  return _downloadedDAO.read(node.uuid(), idDataset, DAO::Storage::handle(_context->uuid));
 }
 
 void StorageService::updateLastSynchronizedId(Entities::Node &node, uint32_t idDataset, uint32_t idHeader, uint32_t idCell) {
-  _downloadedDAO.save(node.uuid(), idDataset, idHeader, idCell, _context->uuid);
+  _downloadedDAO.save(node.uuid(), idDataset, idHeader, idCell, DAO::Storage::handle(_context->uuid));
 }
 
 void StorageService::saveHeader(Entities::Node &node, Entities::Header &header, uint32_t idHeader) {
-  std::unique_ptr<Entities::Dataset> dataset = _datasetDAO.read(header.idDataset(), _context->uuid);
+  // The column family is resolved once; every write of the header goes
+  // through this handle.
+  DAO::Storage::ContextHandle context = DAO::Storage::handle(_context->uuid);
+  std::unique_ptr<Entities::Dataset> dataset = _datasetDAO.read(header.idDataset(), context);
   if (!dataset)
     throw ServiceException("Data set doesn't exist", 435);
 
   dataset->idHeader(dataset->idHeader() + 1);
   header.idHeader(dataset->idHeader());
   header.status(checkHeaderAndTransform(node, header));
-  _headerDAO.save(header, _context->uuid);
+  DAO::Storage::Batch batch;
+  batch.savePoint();
   if (header.status() == ValidationCodes::success) {
-    if (_transactionsManager.executeValidation(header)) {
-      for (Entities::Change &change : header.changes()) {
+    if (_transactionsManager.executeValidation(header, context, batch)) {
+      for (Entities::ChangeView &change : header.changes()) {
         change.idDataset(dataset->id());
         change.idHeader(header.idHeader());
-        header.status(applyChange(node, header, change));
+        header.status(applyChange(node, header, change, context, batch));
         if (header.status() == ValidationCodes::success) {
-          _changeDAO.save(change, _context->uuid);
+          _changeDAO.save(change, context, batch);
         } else if (header.status() != ValidationCodes::skipEntity) {
-          _headerDAO.save(header, _context->uuid);
           break;
         } else {
           header.status(ValidationCodes::success);
@@ -457,13 +448,18 @@ void StorageService::saveHeader(Entities::Node &node, Entities::Header &header,
       header.status(ValidationCodes::userValidation);
     }
   }
-  if (!_transactionsManager.executeCommit(header)) {
+  if (!_transactionsManager.executeCommit(header, context, batch)) {
     if (header.status() == ValidationCodes::success)
       header.status(ValidationCodes::userValidation);
-    _headerDAO.save(header, _context->uuid);
   }
-  _downloadedDAO.save(node.uuid(), header.idDataset(), idHeader, header.idNode(), _context->uuid);
-  _datasetDAO.update(*dataset, _context->uuid);
+  // Entities and changes are only stored when the whole header applied.
+  if (header.status() != ValidationCodes::success)
+    batch.rollback();
+  _headerDAO.save(header, context, batch);
+  _downloadedDAO.save(node.uuid(), header.idDataset(), idHeader, header.idNode(), context, batch);
+  _datasetDAO.update(*dataset, context, batch);
+  DAO::Storage::commit(batch);
+  NotificationHub::publish(_context->uuid, dataset->uuid(), header.idHeader());
   if (header.status() == ValidationCodes::success && header.version() != _context->version) {
 
   }
@@ -226,7 +226,12 @@ std::unique_ptr<Entities::Node> UserService::signIn(const std::string &jwt, cons
     DAO::Storage::Transaction transaction = DAO::Storage::begin();
     std::unique_ptr<Entities::User> user = userDAO.read(email, context);
     if (!user) {
+        uuid_t uuid;
+        char plainUuid[37];
+        uuid_generate_time_safe(uuid);
+        uuid_unparse_lower(uuid, plainUuid);
         user = std::make_unique<Entities::User>();
+        user->uuid(std::string(plainUuid, 36));
         user->identifier(email);
         user->name(name);
         user->type(static_cast<Entities::User::Type>(type));
@@ -27,6 +27,8 @@ SOFTWARE.
 
 #include <sqlite/BinaryEncoder.hpp>
 
+#include <algorithm>
+
 namespace Beehive {
 namespace Services {
 namespace SqLite {
@@ -48,12 +50,18 @@ int BinaryEncoder::putVarint(unsigned char *p, uint64_t v) {
     p[1] = v & 0x7f;
     return 2;
   }
+  if (v <= 0x1fffff) {
+    p[0] = ((v >> 14) & 0x7f) | 0x80;
+    p[1] = ((v >> 7) & 0x7f) | 0x80;
+    p[2] = v & 0x7f;
+    return 3;
+  }
   return 0;
 }
 
 void BinaryEncoder::addInteger(int attribute, uint64_t data) {
   int currpos = varintLen(attribute);
-  uint8_t buffer[currpos + 9];
+  uint8_t *buffer = append(attribute, currpos + 9);
   putVarint(buffer, attribute);
   buffer[currpos++] = AttributeType::Integer;
   buffer[currpos++] = (data >> 56) & 0xFF;
@@ -64,14 +72,13 @@ void BinaryEncoder::addInteger(int attribute, uint64_t data) {
   buffer[currpos++] = (data >> 16) & 0xFF;
   buffer[currpos++] = (data >> 8) & 0xFF;
   buffer[currpos++] = (data >> 0) & 0xFF;
-  _data[attribute] = std::string((char*) buffer, currpos);
 }
 
-void BinaryEncoder::addReal(int attribute, double value) {
+void BinaryEncoder::addReal(int attribute, double real) {
   uint64_t data;
-  memcpy(&data, &value, 8);
+  memcpy(&data, &real, 8);
   int currpos = varintLen(attribute);
-  uint8_t buffer[currpos + 9];
+  uint8_t *buffer = append(attribute, currpos + 9);
   putVarint(buffer, attribute);
   buffer[currpos++] = AttributeType::Real;
   buffer[currpos++] = (data >> 56) & 0xFF;
@@ -82,48 +89,43 @@ void BinaryEncoder::addReal(int attribute, double value) {
   buffer[currpos++] = (data >> 16) & 0xFF;
   buffer[currpos++] = (data >> 8) & 0xFF;
   buffer[currpos++] = (data >> 0) & 0xFF;
-  _data[attribute] = std::string((char*) buffer, currpos);
 }
 
-void BinaryEncoder::addText(int attribute, std::string data) {
+void BinaryEncoder::addText(int attribute, std::string_view data) {
   uint64_t size = data.size();
   int currpos = varintLen(attribute);
-  uint8_t buffer[currpos + size + 4];
+  uint8_t *buffer = append(attribute, currpos + 1 + varintLen(size) + size);
   putVarint(buffer, attribute);
   buffer[currpos++] = AttributeType::Text;
   putVarint(&buffer[currpos], size);
   currpos += varintLen(size);
   data.copy((char*) (buffer + currpos), data.size());
-  _data[attribute] = std::string((char*) buffer, currpos + data.size());
 }
 
-void BinaryEncoder::addBlob(int attribute, std::string data) {
+void BinaryEncoder::addBlob(int attribute, std::string_view data) {
   uint64_t size = data.size();
   int currpos = varintLen(attribute);
-  uint8_t buffer[currpos + size + 4];
+  uint8_t *buffer = append(attribute, currpos + 1 + varintLen(size) + size);
   putVarint(buffer, attribute);
   buffer[currpos++] = AttributeType::Blob;
   putVarint(&buffer[currpos], size);
   currpos += varintLen(size);
   data.copy((char*) (buffer + currpos), data.size());
-  _data[attribute] = std::string((char*) buffer, currpos + data.size());
 }
 
 void BinaryEncoder::addNull(int attribute) {
   int currpos = varintLen(attribute);
-  uint8_t buffer[currpos + 2];
+  uint8_t *buffer = append(attribute, currpos + 1);
   putVarint(buffer, attribute);
   buffer[currpos++] = AttributeType::Null;
-  _data[attribute] = std::string((char*) buffer, currpos);
 }
 
-void BinaryEncoder::addUUID(int attribute, std::string data) {
+void BinaryEncoder::addUUID(int attribute, std::string_view data) {
   int currpos = varintLen(attribute);
-  uint8_t buffer[currpos + 17];
+  uint8_t *buffer = append(attribute, currpos + 17);
   putVarint(buffer, attribute);
   buffer[currpos++] = AttributeType::UuidV1;
   data.copy((char*) (buffer + currpos), 16);
-  _data[attribute] = std::string((char*) buffer, currpos + 16);
 }
 
 void BinaryEncoder::addValue(BinaryDecoder::Value &value) {
@@ -169,18 +171,44 @@ void BinaryEncoder::addValue(TextDecoder::Value &value) {
   }
 }
 
-std::string BinaryEncoder::encodedData() {
-  int size = 0;
-  for (auto &attribute : _data) {
-    size += attribute.second.size();
+uint8_t* BinaryEncoder::append(int attribute, size_t size) {
+  size_t offset = _buffer.size();
+  _buffer.resize(offset + size);
+  auto fragment = std::lower_bound(_fragments.begin(), _fragments.end(), attribute, [](const Fragment &fragment, int attribute) {
+    return fragment.attribute < attribute;
+  });
+  if (fragment != _fragments.end() && fragment->attribute == attribute) {
+    _unused += fragment->size;
+    fragment->offset = offset;
+    fragment->size = size;
+  } else {
+    _fragments.insert(fragment, Fragment { attribute, (uint32_t) offset, (uint32_t) size });
   }
-  uint8_t buffer[size];
-  size = 0;
-  for (auto &attribute : _data) {
-    attribute.second.copy((char*) (buffer + size), attribute.second.size());
-    size += attribute.second.size();
+  return (uint8_t*) (_buffer.data() + offset);
+}
+
+size_t BinaryEncoder::encodedSize() {
+  return _buffer.size() - _unused;
+}
+
+void BinaryEncoder::encode(char *buffer) {
+  for (const Fragment &fragment : _fragments) {
+    memcpy(buffer, _buffer.data() + fragment.offset, fragment.size);
+    buffer += fragment.size;
   }
-  return std::string((char*) buffer, size);
+}
+
+std::string BinaryEncoder::encodedData() {
+  std::string data(encodedSize(), '\0');
+  encode(data.data());
+  return data;
+}
+
+std::string_view BinaryEncoder::encodedData(Memory::Arena &arena) {
+  size_t size = encodedSize();
+  char *buffer = arena.allocate(size);
+  encode(buffer);
+  return std::string_view(buffer, size);
 }
 
 } /* namespace SqLite */
@@ -0,0 +1,136 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <sqlite/ColumnCodec.hpp>
+
+#include <sqlite/DecoderException.hpp>
+
+#include <algorithm>
+
+namespace Beehive {
+namespace Services {
+namespace SqLite {
+
+namespace {
+
+const uint32_t MaxDisplacement = 1 << 20;
+
+inline char fold(char c) {
+  return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+uint32_t tableSize(size_t columns) {
+  uint32_t size = 1;
+  while (size < columns * 2)
+    size <<= 1;
+  return size;
+}
+
+} /* namespace */
+
+ColumnCodec::ColumnCodec(const std::unordered_map<std::string, int, Utils::IHasher, Utils::IEqualsComparator> &columns) :
+    _mask(0) {
+  if (columns.empty())
+    return;
+  uint32_t size = tableSize(columns.size());
+  _mask = size - 1;
+  _displacements.assign(size, 0);
+  _slots.assign(size, Slot { std::string(), -1 });
+
+  std::vector<std::vector<std::pair<std::string, int>>> buckets(size);
+  for (auto &column : columns) {
+    std::string name(column.first);
+    std::transform(name.begin(), name.end(), name.begin(), fold);
+    buckets[hash(name, 0) & _mask].emplace_back(std::move(name), column.second);
+  }
+  std::vector<uint32_t> order(size);
+  for (uint32_t i = 0; i < size; ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b) {
+    return buckets[a].size() > buckets[b].size();
+  });
+
+  std::vector<uint32_t> placed;
+  for (uint32_t bucket : order) {
+    if (buckets[bucket].empty())
+      break;
+    for (uint32_t displacement = 1;; ++displacement) {
+      if (displacement > MaxDisplacement)
+        throw DecoderException("Unable to build column table", 0);
+      placed.clear();
+      for (auto &column : buckets[bucket]) {
+        uint32_t slot = hash(column.first, displacement) & _mask;
+        if (_slots[slot].id != -1 || std::find(placed.begin(), placed.end(), slot) != placed.end())
+          break;
+        placed.push_back(slot);
+      }
+      if (placed.size() != buckets[bucket].size())
+        continue;
+      for (size_t i = 0; i < placed.size(); ++i)
+        _slots[placed[i]] = Slot { std::move(buckets[bucket][i].first), buckets[bucket][i].second };
+      _displacements[bucket] = displacement;
+      break;
+    }
+  }
+}
+
+int ColumnCodec::find(std::string_view name) const {
+  if (_slots.empty())
+    return -1;
+  uint32_t displacement = _displacements[hash(name, 0) & _mask];
+  if (displacement == 0)
+    return -1;
+  const Slot &slot = _slots[hash(name, displacement) & _mask];
+  if (slot.id == -1 || !equals(slot.name, name))
+    return -1;
+  return slot.id;
+}
+
+uint32_t ColumnCodec::hash(std::string_view name, uint32_t seed) {
+  uint32_t hash = 2166136261u ^ (seed * 0x9e3779b9u);
+  for (char c : name) {
+    hash ^= (uint8_t) fold(c);
+    hash *= 16777619u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  return hash;
+}
+
+bool ColumnCodec::equals(std::string_view folded, std::string_view name) {
+  if (folded.size() != name.size())
+    return false;
+  for (size_t i = 0; i < name.size(); ++i) {
+    if (folded[i] != fold(name[i]))
+      return false;
+  }
+  return true;
+}
+
+} /* namespace SqLite */
+} /* namespace Services */
+} /* namespace Beehive */
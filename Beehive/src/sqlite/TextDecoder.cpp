@@ -40,7 +40,7 @@ uint16_t TextDecoder::Value::id() {
   return _currentId;
 }
 
-std::string TextDecoder::Value::column() {
+std::string_view TextDecoder::Value::column() {
   return _current;
 }
 
@@ -86,21 +86,21 @@ double TextDecoder::Value::realValue() {
   }
 }
 
-std::string TextDecoder::Value::textValue() {
+std::string_view TextDecoder::Value::textValue() {
   if (*((char*) (_data + _current.length() + 1)) == AttributeType::Text) {
     uint32_t lenght;
     const char *data = _data + _current.length() + 2 + variantLenght(lenght, _data + _current.length() + 2);
-    return std::string(data, lenght);
+    return std::string_view(data, lenght);
   } else {
     throw NavigationException("Invalid data type request");
   }
 }
 
-std::string TextDecoder::Value::blobValue() {
+std::string_view TextDecoder::Value::blobValue() {
   if (*((char*) (_data + _current.length() + 1)) == AttributeType::Blob) {
     uint32_t lenght;
     const char *data = _data + _current.length() + 2 + variantLenght(lenght, _data + _current.length() + 2);
-    return std::string(data, lenght);
+    return std::string_view(data, lenght);
   } else {
     throw NavigationException("Invalid data type request");
   }
@@ -131,11 +131,11 @@ bool TextDecoder::Value::operator!=(const Value &rhs) const {
 
 uint16_t TextDecoder::Value::goForward(bool skip) {
   while (_data < _end) {
-    auto columnPtr = _mapping.find(_current);
-    if (columnPtr != _mapping.end() && !skip) {
-      return columnPtr->second;
+    int column = _codec.find(_current);
+    if (column != -1 && !skip) {
+      return column;
     } else if (!skip) {
-      LOG_WARN << "Skipping field '" << _entity << "." << _current << "'.";
+      LOG_WARN << "Skipping field '" << std::string(_entity) << "." << std::string(_current) << "'.";
     }
     const char *data = _data + _current.length() + 1;
     switch (*data) {
@@ -157,7 +157,7 @@ uint16_t TextDecoder::Value::goForward(bool skip) {
     }
     _data = data;
     if (_data < _end)
-      _current = data;
+      _current = std::string_view(_data, strnlen(_data, _end - _data));
     skip = false;
   }
   return -1;
@@ -216,11 +216,11 @@ TextDecoder::Value& TextDecoder::iterator::operator*() {
 }
 
 TextDecoder::iterator TextDecoder::begin() {
-  return iterator(_data, _size, _mapping, _entity);
+  return iterator(_data, _size, _codec, _entity);
 }
 
 TextDecoder::iterator TextDecoder::end() {
-  return iterator(_data + _size, 0, _mapping, _entity);
+  return iterator(_data + _size, 0, _codec, _entity);
 }
 
 } /* namespace SqLite */
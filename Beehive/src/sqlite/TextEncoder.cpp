@@ -95,7 +95,7 @@ void TextEncoder::addReal(int attribute, double value) {
   }
 }
 
-void TextEncoder::addText(int attribute, std::string data) {
+void TextEncoder::addText(int attribute, std::string_view data) {
   auto attributePtr = _mapping.find(attribute);
   if (attributePtr != _mapping.end()) {
     uint64_t size = data.size();
@@ -111,7 +111,7 @@ void TextEncoder::addText(int attribute, std::string data) {
   }
 }
 
-void TextEncoder::addBlob(int attribute, std::string data) {
+void TextEncoder::addBlob(int attribute, std::string_view data) {
   auto attributePtr = _mapping.find(attribute);
   if (attributePtr != _mapping.end()) {
     uint64_t size = data.size();
@@ -44,15 +44,15 @@ struct nocaseEqualsCompare {
   }
 };
 
-bool ILessComparator::operator()(const std::string &str1, const std::string &str2) const {
+bool ILessComparator::operator()(std::string_view str1, std::string_view str2) const {
   return std::lexicographical_compare(str1.begin(), str1.end(), str2.begin(), str2.end(), nocaseLessCompare());
 }
 
-bool IEqualsComparator::operator()(const std::string &str1, const std::string &str2) const {
-  return std::lexicographical_compare(str1.begin(), str1.end(), str2.begin(), str2.end(), nocaseEqualsCompare());
+bool IEqualsComparator::operator()(std::string_view str1, std::string_view str2) const {
+  return std::equal(str1.begin(), str1.end(), str2.begin(), str2.end(), nocaseEqualsCompare());
 }
 
-size_t IHasher::operator()(std::string const &key) const {
+size_t IHasher::operator()(std::string_view key) const {
   size_t hash = 0;
   std::for_each(key.begin(), key.end(), [&hash](const char &c) {
     hash = hash * 31 + static_cast<int>(::tolower(c));
@@ -0,0 +1,114 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <tcp/Checksum.hpp>
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace Beehive {
+namespace Services {
+namespace TCP {
+
+template<typename T, T Polynomial>
+constexpr std::array<std::array<T, 256>, 8> slicingTables() {
+  std::array<std::array<T, 256>, 8> tables { };
+  for (unsigned i = 0; i < 256; i++) {
+    T crc = i;
+    for (int j = 0; j < 8; j++)
+      crc = (crc & 1) ? (crc >> 1) ^ Polynomial : crc >> 1;
+    tables[0][i] = crc;
+  }
+  for (unsigned i = 0; i < 256; i++)
+    for (int k = 1; k < 8; k++)
+      tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xff];
+  return tables;
+}
+
+static constexpr std::array<std::array<uint16_t, 256>, 8> crc16Tables = slicingTables<uint16_t, 0xA001>();
+static constexpr std::array<std::array<uint32_t, 256>, 8> crc32cTables = slicingTables<uint32_t, 0x82F63B78>();
+
+static inline uint64_t loadLittleEndian(const uint8_t *data) {
+  uint64_t word;
+  memcpy(&word, data, sizeof(word));
+#if BYTE_ORDER == BIG_ENDIAN
+  word = __builtin_bswap64(word);
+#endif
+  return word;
+}
+
+template<typename T>
+static T slicingBy8(const std::array<std::array<T, 256>, 8> &tables, T crc, const uint8_t *data, size_t size) {
+  while (8 <= size) {
+    uint64_t word = loadLittleEndian(data) ^ crc;
+    crc = tables[7][word & 0xff] ^ tables[6][(word >> 8) & 0xff] ^ tables[5][(word >> 16) & 0xff] ^ tables[4][(word >> 24) & 0xff] //
+    ^ tables[3][(word >> 32) & 0xff] ^ tables[2][(word >> 40) & 0xff] ^ tables[1][(word >> 48) & 0xff] ^ tables[0][word >> 56];
+    data += 8;
+    size -= 8;
+  }
+  while (size--)
+    crc = (crc >> 8) ^ tables[0][(crc ^ *data++) & 0xff];
+  return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2")))
+static uint32_t crc32cHardware(uint32_t crc, const uint8_t *data, size_t size) {
+  uint64_t value = crc;
+  while (8 <= size) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    value = _mm_crc32_u64(value, word);
+    data += 8;
+    size -= 8;
+  }
+  crc = (uint32_t) value;
+  while (size--)
+    crc = _mm_crc32_u8(crc, *data++);
+  return crc;
+}
+#endif
+
+uint16_t crc16(uint16_t crc, const void *data, size_t size) {
+  return slicingBy8(crc16Tables, crc, (const uint8_t*) data, size);
+}
+
+uint32_t crc32c(uint32_t crc, const void *data, size_t size) {
+#if defined(__x86_64__)
+  static const bool hardware = __builtin_cpu_supports("sse4.2");
+  if (hardware)
+    return ~crc32cHardware(~crc, (const uint8_t*) data, size);
+#endif
+  return ~slicingBy8(crc32cTables, (uint32_t) ~crc, (const uint8_t*) data, size);
+}
+
+} /* namespace TCP */
+} /* namespace Services */
+} /* namespace Beehive */
@@ -0,0 +1,143 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <tcp/Compression.hpp>
+#include <tcp/TCPException.hpp>
+
+#include <nanolog/NanoLog.hpp>
+
+#include <lz4.h>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace Beehive {
+namespace Services {
+namespace TCP {
+
+std::string Dictionary::_directory;
+std::mutex Dictionary::_mutex;
+std::unordered_map<std::string, std::shared_ptr<const Dictionary>> Dictionary::_dictionaries;
+
+Dictionary::Dictionary(const std::string &data) :
+    _compress(ZSTD_createCDict(data.data(), data.size(), Compressor::Level)), _decompress(ZSTD_createDDict(data.data(), data.size())), _id(0) {
+  if (_compress == nullptr || _decompress == nullptr) {
+    ZSTD_freeCDict(_compress);
+    ZSTD_freeDDict(_decompress);
+    throw std::runtime_error("Invalid compression dictionary");
+  }
+  _id = ZSTD_getDictID_fromDDict(_decompress);
+}
+
+Dictionary::~Dictionary() {
+  ZSTD_freeCDict(_compress);
+  ZSTD_freeDDict(_decompress);
+}
+
+void Dictionary::directory(const std::string &directory) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _directory = directory;
+  _dictionaries.clear();
+}
+
+std::shared_ptr<const Dictionary> Dictionary::get(const std::string &context) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_directory.empty())
+    return nullptr;
+  auto dictionaryPtr = _dictionaries.find(context);
+  if (dictionaryPtr != _dictionaries.end())
+    return dictionaryPtr->second;
+  std::shared_ptr<const Dictionary> dictionary;
+  std::ifstream file(_directory + "/" + context + ".dict", std::ios::binary);
+  if (file) {
+    std::stringstream data;
+    data << file.rdbuf();
+    try {
+      dictionary.reset(new Dictionary(data.str()));
+    } catch (std::runtime_error &e) {
+      LOG_ERROR << e.what() << " for context " << context;
+    }
+  }
+  _dictionaries.emplace(context, dictionary);
+  return dictionary;
+}
+
+Compressor::~Compressor() {
+  ZSTD_freeCCtx(_compress);
+  ZSTD_freeDCtx(_decompress);
+}
+
+void Compressor::compress(Compression algorithm, const uint8_t *data, size_t size, std::vector<uint8_t> &output) {
+  size_t begin = output.size();
+  if (algorithm == Compression::LZ4) {
+    output.resize(begin + LZ4_compressBound((int) size));
+    int written = LZ4_compress_default((const char*) data, (char*) output.data() + begin, (int) size, (int) (output.size() - begin));
+    if (written <= 0)
+      throw std::runtime_error("Unable to compress the frame");
+    output.resize(begin + written);
+  } else {
+    if (_compress == nullptr && (_compress = ZSTD_createCCtx()) == nullptr)
+      throw std::runtime_error("Unable to create the compression context");
+    output.resize(begin + ZSTD_compressBound(size));
+    size_t written;
+    if (_dictionary)
+      written = ZSTD_compress_usingCDict(_compress, output.data() + begin, output.size() - begin, data, size, _dictionary->_compress);
+    else
+      written = ZSTD_compressCCtx(_compress, output.data() + begin, output.size() - begin, data, size, Level);
+    if (ZSTD_isError(written))
+      throw std::runtime_error(std::string("Unable to compress the frame: ") + ZSTD_getErrorName(written));
+    output.resize(begin + written);
+  }
+}
+
+void Compressor::decompress(Compression algorithm, const uint8_t *data, size_t compressedSize, size_t size, std::vector<uint8_t> &output) {
+  size_t begin = output.size();
+  output.resize(begin + size);
+  if (algorithm == Compression::LZ4) {
+    int readed = LZ4_decompress_safe((const char*) data, (char*) output.data() + begin, (int) compressedSize, (int) size);
+    if (readed < 0 || (size_t) readed != size)
+      throw TransmissionErrorException("Invalid compressed frame", 0);
+  } else {
+    if (_decompress == nullptr && (_decompress = ZSTD_createDCtx()) == nullptr)
+      throw std::runtime_error("Unable to create the decompression context");
+    unsigned id = ZSTD_getDictID_fromFrame(data, compressedSize);
+    size_t readed;
+    if (id == 0)
+      readed = ZSTD_decompressDCtx(_decompress, output.data() + begin, size, data, compressedSize);
+    else if (_dictionary && _dictionary->id() == id)
+      readed = ZSTD_decompress_usingDDict(_decompress, output.data() + begin, size, data, compressedSize, _dictionary->_decompress);
+    else
+      throw TransmissionErrorException("Unknown compression dictionary " + std::to_string(id), 0);
+    if (ZSTD_isError(readed) || readed != size)
+      throw TransmissionErrorException("Invalid compressed frame", 0);
+  }
+}
+
+} /* namespace TCP */
+} /* namespace Services */
+} /* namespace Beehive */
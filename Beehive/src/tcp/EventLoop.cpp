@@ -0,0 +1,331 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <tcp/EventLoop.hpp>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <nanolog/NanoLog.hpp>
+
+namespace Beehive {
+namespace Services {
+namespace TCP {
+
+static const uint32_t ClientEvents = EPOLLIN | EPOLLRDHUP | EPOLLET | EPOLLONESHOT;
+
+EventLoop::EventLoop() :
+    _epoll(epoll_create1(EPOLL_CLOEXEC)), _wakeup(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), _listenSocket(-1), _maxConnections(0), _running(false), _returned(nullptr), _timers(std::chrono::milliseconds(100)) {
+}
+
+EventLoop::~EventLoop() {
+  close(_wakeup);
+  close(_epoll);
+}
+
+void EventLoop::run(int listenSocket, size_t maxConnections, size_t workers, Factory factory) {
+  if (_epoll < 0 || _wakeup < 0) {
+    LOG_ERROR << "Unable to create the event loop: " << strerror(errno);
+    return;
+  }
+  _listenSocket = listenSocket;
+  _maxConnections = maxConnections;
+  _factory = factory;
+  fcntl(_listenSocket, F_SETFL, fcntl(_listenSocket, F_GETFL, 0) | O_NONBLOCK);
+  epoll_event event;
+  event.events = EPOLLIN | EPOLLET;
+  event.data.ptr = &_listenSocket;
+  if (epoll_ctl(_epoll, EPOLL_CTL_ADD, _listenSocket, &event) != 0) {
+    LOG_ERROR << "Unable to watch the listening socket: " << strerror(errno);
+    return;
+  }
+  event.events = EPOLLIN;
+  event.data.ptr = &_wakeup;
+  if (epoll_ctl(_epoll, EPOLL_CTL_ADD, _wakeup, &event) != 0) {
+    LOG_ERROR << "Unable to watch the wakeup descriptor: " << strerror(errno);
+    return;
+  }
+  _running = true;
+  if (workers == 0)
+    workers = 1;
+  for (size_t i = 0; i < workers; i++)
+    _workers.emplace_back(&EventLoop::work, this);
+  epoll_event events[128];
+  while (_running) {
+    int count = epoll_wait(_epoll, events, 128, _timers.timeout());
+    if (count < 0) {
+      if (errno == EINTR)
+        continue;
+      LOG_ERROR << "Error while waiting for events: " << strerror(errno);
+      break;
+    }
+    for (int i = 0; i < count; i++) {
+      if (events[i].data.ptr == &_listenSocket) {
+        accept();
+      } else if (events[i].data.ptr == &_wakeup) {
+        uint64_t value;
+        while (0 < read(_wakeup, &value, sizeof(value))) {
+        }
+      } else {
+        Connection *connection = (Connection*) events[i].data.ptr;
+        connection->idle = false;
+        _timers.cancel(connection);
+        dispatch(connection);
+      }
+    }
+    resubscribe();
+    awaken();
+    expire();
+  }
+  _running = false;
+  _wait.notify_all();
+  for (std::thread &worker : _workers)
+    worker.join();
+  _workers.clear();
+  for (Connection *connection : _connections) {
+    close(connection->socket);
+    delete connection;
+  }
+  _connections.clear();
+  _ready.clear();
+  _woken.clear();
+}
+
+void EventLoop::finish() {
+  _running = false;
+  uint64_t value = 1;
+  if (write(_wakeup, &value, sizeof(value)) < 0) {
+    LOG_ERROR << "Unable to wake up the event loop: " << strerror(errno);
+  }
+}
+
+void EventLoop::accept() {
+  while (true) {
+    struct sockaddr_in6 clientAddr;
+    socklen_t addrLen = sizeof(clientAddr);
+    int clientSocket = accept4(_listenSocket, (struct sockaddr*) &clientAddr, &addrLen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (clientSocket < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        LOG_ERROR << "Unable to accept a connection: " << strerror(errno);
+      return;
+    }
+    char str[INET6_ADDRSTRLEN];
+    if (inet_ntop(AF_INET6, &clientAddr.sin6_addr, str, sizeof(str))) {
+      LOG_DEBUG << "Connection received form: " << str << ":" << ntohs(clientAddr.sin6_port);
+    }
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_maxConnections <= _connections.size()) {
+      lock.unlock();
+      LOG_WARN << "Connection limit of " << _maxConnections << " reached, rejecting connection";
+      close(clientSocket);
+      continue;
+    }
+    Connection *connection = new Connection(clientSocket, _factory(clientSocket));
+    connection->handler->wakeup([this, connection]() {
+      wake(connection);
+    });
+    _connections.insert(connection);
+    lock.unlock();
+    epoll_event event;
+    event.events = ClientEvents;
+    event.data.ptr = connection;
+    if (epoll_ctl(_epoll, EPOLL_CTL_ADD, clientSocket, &event) == 0) {
+      connection->idle = true;
+      connection->registered = true;
+      _timers.schedule(connection, connection->handler->timeout());
+    } else {
+      LOG_ERROR << "Unable to watch a client socket: " << strerror(errno);
+      release(connection);
+    }
+  }
+}
+
+void EventLoop::dispatch(Connection *connection) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _ready.push_back(connection);
+  }
+  _wait.notify_one();
+}
+
+void EventLoop::resubscribe() {
+  Connection *connection = _returned.exchange(nullptr);
+  while (connection) {
+    Connection *next = connection->returned;
+    connection->returned = nullptr;
+    if (connection->closed) {
+      release(connection);
+      connection = next;
+      continue;
+    }
+    if (claim(connection)) {
+      dispatch(connection);
+      connection = next;
+      continue;
+    }
+    epoll_event event;
+    event.events = ClientEvents;
+    event.data.ptr = connection;
+    if (epoll_ctl(_epoll, connection->registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, connection->socket, &event) == 0) {
+      connection->idle = true;
+      connection->registered = true;
+      _timers.schedule(connection, connection->handler->timeout());
+    } else {
+      LOG_ERROR << "Unable to watch a client socket: " << strerror(errno);
+      release(connection);
+    }
+    connection = next;
+  }
+}
+
+void EventLoop::awaken() {
+  std::vector<Connection*> woken;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto connectionPtr = _woken.begin();
+    while (connectionPtr != _woken.end()) {
+      if ((*connectionPtr)->idle) {
+        (*connectionPtr)->woken = false;
+        woken.push_back(*connectionPtr);
+        connectionPtr = _woken.erase(connectionPtr);
+      } else {
+        ++connectionPtr;
+      }
+    }
+  }
+  // An armed registration still reports hang ups and errors, so the socket
+  // leaves epoll until the worker gives the connection back.
+  for (Connection *connection : woken) {
+    if (epoll_ctl(_epoll, EPOLL_CTL_DEL, connection->socket, nullptr) != 0)
+      LOG_ERROR << "Unable to disarm a client socket: " << strerror(errno);
+    connection->registered = false;
+    connection->idle = false;
+    _timers.cancel(connection);
+    dispatch(connection);
+  }
+}
+
+void EventLoop::expire() {
+  TimerWheel::Timer *timer = _timers.advance();
+  while (timer) {
+    Connection *connection = static_cast<Connection*>(timer);
+    timer = TimerWheel::next(timer);
+    LOG_DEBUG << "Closing idle connection";
+    release(connection);
+  }
+}
+
+void EventLoop::work() {
+  while (true) {
+    Connection *connection;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _wait.wait(lock, [&]() {
+        return !_ready.empty() || !_running;
+      });
+      if (!_running)
+        return;
+      connection = _ready.front();
+      _ready.pop_front();
+    }
+    // A request that arrives in pieces keeps the deadline set when it began.
+    if (!connection->handler->receiving())
+      connection->handler->arm(MessageTimeout);
+    claim(connection);
+    bool keep = connection->handler->resume();
+    while (keep && (connection->handler->buffered() || claim(connection))) {
+      if (!connection->handler->receiving())
+        connection->handler->arm(MessageTimeout);
+      keep = connection->handler->resume();
+    }
+    // Closed connections are given back too, so the reactor is the only
+    // thread that touches epoll and deletes connections. The reactor may take
+    // the connection as soon as it is pushed, so the previous head is read
+    // from a local.
+    connection->closed = !keep;
+    Connection *head = _returned.load();
+    do {
+      connection->returned = head;
+    } while (!_returned.compare_exchange_weak(head, connection));
+    if (head == nullptr) {
+      uint64_t value = 1;
+      if (write(_wakeup, &value, sizeof(value)) < 0) {
+        LOG_ERROR << "Unable to wake up the event loop: " << strerror(errno);
+      }
+    }
+  }
+}
+
+void EventLoop::wake(Connection *connection) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_connections.find(connection) == _connections.end() || connection->woken)
+      return;
+    connection->woken = true;
+    _woken.push_back(connection);
+  }
+  uint64_t value = 1;
+  if (write(_wakeup, &value, sizeof(value)) < 0) {
+    LOG_ERROR << "Unable to wake up the event loop: " << strerror(errno);
+  }
+}
+
+// Clears the pending wake of a connection that is about to be resumed.
+bool EventLoop::claim(Connection *connection) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (!connection->woken)
+    return false;
+  connection->woken = false;
+  _woken.erase(std::find(_woken.begin(), _woken.end(), connection));
+  return true;
+}
+
+void EventLoop::release(Connection *connection) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _connections.erase(connection);
+    if (connection->woken)
+      _woken.erase(std::find(_woken.begin(), _woken.end(), connection));
+  }
+  epoll_ctl(_epoll, EPOLL_CTL_DEL, connection->socket, nullptr);
+  close(connection->socket);
+  delete connection;
+}
+
+} /* namespace TCP */
+} /* namespace Services */
+} /* namespace Beehive */
@@ -26,12 +26,16 @@ SOFTWARE.
 
 
 #include <tcp/TCPHandler.hpp>
-#include <tcp/SocketWatcher.hpp>
 #include <tcp/TCPException.hpp>
 
+#include <nanolog/NanoLog.hpp>
+
+#include <errno.h>
 #include <unistd.h>
 #include <stdint.h>
+#include <string.h>
 #include <netinet/in.h>
+#include <poll.h>
 
 namespace Beehive {
 namespace Services {
@@ -64,68 +68,361 @@ uint64_t ntohll(uint64_t x) {
 #endif
 }
 
-static bool crc_tab16_init = false;
-static uint16_t crc_tab16[256];
-
-void init_crc16_tab(void) {
-  uint16_t i;
-  uint16_t j;
-  uint16_t crc;
-  uint16_t c;
-  for (i = 0; i < 256; i++) {
-    crc = 0;
-    c = i;
-    for (j = 0; j < 8; j++) {
-      if ((crc ^ c) & 0x0001)
-        crc = (crc >> 1) ^ 0xA001;
-      else
-        crc = crc >> 1;
-      c = c >> 1;
+uint32_t TCPHandler::_maxFrameSize = 1048576;
+
+uint32_t TCPHandler::digest(Checksum checksum, uint32_t crc, const void *ptr, size_t size) {
+  if (checksum == Checksum::CRC32C)
+    return crc32c(crc, ptr, size);
+  else
+    return crc16((uint16_t) crc, ptr, size);
+}
+
+void TCPHandler::update(uint32_t &crc, const void *ptr, size_t size) const {
+  if (_inFrame || _replying)
+    return;
+  crc = digest(_checksum, crc, ptr, size);
+}
+
+bool TCPHandler::await(short events) {
+  struct pollfd descriptor;
+  descriptor.fd = _socket;
+  descriptor.events = events;
+  descriptor.revents = 0;
+  int ready;
+  do {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(_deadline - std::chrono::steady_clock::now());
+    if (remaining.count() <= 0) {
+      LOG_WARN << "Timeout waiting for the socket";
+      return false;
+    }
+    ready = poll(&descriptor, 1, (int) remaining.count());
+  } while (ready < 0 && errno == EINTR);
+  return 0 < ready && (descriptor.revents & events);
+}
+
+std::chrono::milliseconds TCPHandler::timeout() const {
+  if (!receiving())
+    return _idleTimeout;
+  auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(_deadline - std::chrono::steady_clock::now());
+  return remaining.count() < 0 ? std::chrono::milliseconds(0) : remaining;
+}
+
+bool TCPHandler::fill(size_t size) {
+  if (_inputEnd - _inputBegin >= size)
+    return true;
+  flush();
+  if (_marked && BufferSize < _inputBegin - _mark + size)
+    _marked = false;
+  size_t keep = _marked ? _mark : _inputBegin;
+  if (keep != 0) {
+    memmove(_input, _input + keep, _inputEnd - keep);
+    _inputEnd -= keep;
+    _inputBegin -= keep;
+    _mark = 0;
+  }
+  while (_inputEnd - _inputBegin < size) {
+    ssize_t readed = read(_socket, _input + _inputEnd, BufferSize - _inputEnd);
+    if (0 < readed) {
+      _inputEnd += readed;
+      _partial = false;
+    } else if (readed < 0 && errno == EINTR) {
+      continue;
+    } else if (readed < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && _marked) {
+      throw IncompleteMessageException();
+    } else if (readed < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && await(POLLIN)) {
+      continue;
+    } else {
+      return false;
     }
-    crc_tab16[i] = crc;
   }
-  crc_tab16_init = true;
+  return true;
 }
 
-uint16_t update_crc_16(uint16_t crc, unsigned char c) {
-  uint16_t tmp;
-  uint16_t short_c;
-  short_c = 0x00ff & (uint16_t) c;
-  if (!crc_tab16_init)
-    init_crc16_tab();
-  tmp = crc ^ short_c;
-  crc = (crc >> 8) ^ crc_tab16[tmp & 0xff];
-  return crc;
+bool TCPHandler::available() {
+  if (_inputBegin != _inputEnd)
+    return true;
+  _inputBegin = 0;
+  _inputEnd = 0;
+  while (true) {
+    ssize_t readed = read(_socket, _input, BufferSize);
+    if (0 < readed) {
+      _inputEnd = readed;
+      _partial = false;
+      return true;
+    } else if (readed < 0 && errno == EINTR) {
+      continue;
+    } else {
+      return !(readed < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+    }
+  }
+}
+
+void TCPHandler::receive(void *ptr, size_t size) {
+  if (_inFrame) {
+    if (_frame.size() - _frameBegin < size)
+      throw TransmissionErrorException("Not enough data in the frame", 0);
+    memcpy(ptr, _frame.data() + _frameBegin, size);
+    _frameBegin += size;
+    return;
+  }
+  uint8_t *target = (uint8_t*) ptr;
+  while (0 < size) {
+    if (_inputBegin == _inputEnd && !fill(size < BufferSize ? size : BufferSize)) {
+      throw TransmissionErrorException("Not enough data in the buffer", 0);
+    }
+    size_t length = _inputEnd - _inputBegin;
+    if (size < length)
+      length = size;
+    memcpy(target, _input + _inputBegin, length);
+    _inputBegin += length;
+    target += length;
+    size -= length;
+  }
+}
+
+void TCPHandler::transmit(const void *ptr, size_t size) {
+  if (_replying) {
+    _reply.insert(_reply.end(), (const uint8_t*) ptr, (const uint8_t*) ptr + size);
+    return;
+  }
+  if (BufferSize - _outputEnd < size) {
+    flush();
+  }
+  if (BufferSize <= size) {
+    const uint8_t *source = (const uint8_t*) ptr;
+    while (0 < size) {
+      ssize_t written = write(_socket, source, size);
+      if (0 < written) {
+        source += written;
+        size -= written;
+      } else if (written < 0 && errno == EINTR) {
+        continue;
+      } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && await(POLLOUT)) {
+        continue;
+      } else {
+        throw TransmissionErrorException("Network error while writing output data", 0);
+      }
+    }
+  } else {
+    memcpy(_output + _outputEnd, ptr, size);
+    _outputEnd += size;
+  }
+}
+
+void TCPHandler::flush() {
+  size_t begin = 0;
+  while (begin < _outputEnd) {
+    ssize_t written = write(_socket, _output + begin, _outputEnd - begin);
+    if (0 < written) {
+      begin += written;
+    } else if (written < 0 && errno == EINTR) {
+      continue;
+    } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && await(POLLOUT)) {
+      continue;
+    } else {
+      _outputEnd = 0;
+      throw TransmissionErrorException("Network error while writing output data", 0);
+    }
+  }
+  _outputEnd = 0;
 }
 
 uint8_t TCPHandler::readOperation() {
-  SocketWatcher::Watcher watcher(_socket);
-  uint8_t value;
-  if (sizeof(uint8_t) != read(_socket, &value, sizeof(uint8_t)))
+  if (!fill(sizeof(uint8_t)))
     return 0;
   else
-    return value;
+    return _input[_inputBegin++];
 }
 
-uint8_t TCPHandler::readUInt8(uint8_t max) {
-  SocketWatcher::Watcher watcher(_socket);
-  uint8_t value;
-  if (sizeof(uint8_t) != read(_socket, &value, sizeof(uint8_t))) {
+// Size of the incoming frame, header and checksum included, checked from its
+// header.
+size_t TCPHandler::frameSize() const {
+  uint32_t length;
+  memcpy(&length, _incoming.data() + 2, sizeof(uint32_t));
+  length = ntohl(length);
+  uint8_t flags = _incoming[1];
+  if ((flags & ~(FrameFlags::Compressed | FrameFlags::Tagged)) != 0 || ((flags & FrameFlags::Compressed) && _compression == Compression::None)) {
+    throw TransmissionErrorException("Unsupported frame flags " + std::to_string(flags), 0);
+  }
+  if (_maxFrameSize < length) {
+    throw TransmissionErrorException("Frame size to big wanted " + std::to_string(_maxFrameSize) + " readed " + std::to_string(length), 0);
+  }
+  return FrameHeaderSize + length + (_checksum == Checksum::CRC32C ? sizeof(uint32_t) : sizeof(uint16_t));
+}
+
+bool TCPHandler::frameReady() {
+  if (_incomingEnd == 0)
+    _incoming.resize(FrameHeaderSize);
+  while (_incomingEnd < _incoming.size()) {
+    if (_inputBegin == _inputEnd && !available())
+      return false;
+    if (_inputBegin == _inputEnd)
+      return true;
+    size_t length = _inputEnd - _inputBegin;
+    if (_incoming.size() - _incomingEnd < length)
+      length = _incoming.size() - _incomingEnd;
+    memcpy(_incoming.data() + _incomingEnd, _input + _inputBegin, length);
+    _inputBegin += length;
+    _incomingEnd += length;
+    if (_incomingEnd == FrameHeaderSize && _incoming.size() == FrameHeaderSize)
+      _incoming.resize(frameSize());
+  }
+  return true;
+}
+
+uint8_t TCPHandler::readFrame() {
+  _inFrame = false;
+  _replying = false;
+  _requestTagged = false;
+  while (!frameReady()) {
+    flush();
+    if (!await(POLLIN))
+      break;
+  }
+  if (_incomingEnd < FrameHeaderSize) {
+    _incomingEnd = 0;
+    return 0;
+  }
+  if (_incomingEnd < _incoming.size()) {
+    _incomingEnd = 0;
     throw TransmissionErrorException("Not enough data in the buffer", 0);
   }
+  _incomingEnd = 0;
+  uint8_t flags = _incoming[1];
+  uint32_t length;
+  memcpy(&length, _incoming.data() + 2, sizeof(uint32_t));
+  length = ntohl(length);
+  uint32_t crc;
+  if (_checksum == Checksum::CRC32C) {
+    memcpy(&crc, _incoming.data() + FrameHeaderSize + length, sizeof(uint32_t));
+    crc = ntohl(crc);
+  } else {
+    uint16_t value;
+    memcpy(&value, _incoming.data() + FrameHeaderSize + length, sizeof(uint16_t));
+    crc = ntohs(value);
+  }
+  _frame.swap(_incoming);
+  _frame.resize(FrameHeaderSize + length);
+  if (crc != digest(_checksum, 0, _frame.data(), _frame.size())) {
+    throw TransmissionErrorException("Invalid frame checksum", 0);
+  }
+  if (flags & FrameFlags::Compressed) {
+    if (length < sizeof(uint32_t))
+      throw TransmissionErrorException("Invalid compressed frame", 0);
+    uint32_t size;
+    memcpy(&size, _frame.data() + FrameHeaderSize, sizeof(uint32_t));
+    size = ntohl(size);
+    if (_maxFrameSize < size) {
+      throw TransmissionErrorException("Frame size to big wanted " + std::to_string(_maxFrameSize) + " readed " + std::to_string(size), 0);
+    }
+    _scratch.assign(_frame.begin(), _frame.begin() + FrameHeaderSize);
+    _compressor.decompress(_compression, _frame.data() + FrameHeaderSize + sizeof(uint32_t), length - sizeof(uint32_t), size, _scratch);
+    _frame.swap(_scratch);
+  }
+  _frameBegin = FrameHeaderSize;
+  if (flags & FrameFlags::Tagged) {
+    if (_frame.size() < FrameHeaderSize + sizeof(uint32_t))
+      throw TransmissionErrorException("Invalid tagged frame", 0);
+    memcpy(&_requestId, _frame.data() + FrameHeaderSize, sizeof(uint32_t));
+    _requestId = ntohl(_requestId);
+    _requestTagged = true;
+    _frameBegin += sizeof(uint32_t);
+  }
+  _inFrame = true;
+  return _frame[0];
+}
+
+void TCPHandler::beginFrame(uint8_t operation, bool reply) {
+  _replyTagged = reply && _requestTagged;
+  _reply.assign(FrameHeaderSize, 0);
+  if (_replyTagged) {
+    uint32_t id = htonl(_requestId);
+    _reply.insert(_reply.end(), (const uint8_t*) &id, (const uint8_t*) &id + sizeof(uint32_t));
+  }
+  _replyOperation = operation;
+  _replyChecksum = _checksum;
+  _replyCompression = _compression;
+  _replying = true;
+}
+
+void TCPHandler::discardFrame() {
+  if (_replying)
+    _reply.resize(FrameHeaderSize + (_replyTagged ? sizeof(uint32_t) : 0));
+}
+
+void TCPHandler::endFrame() {
+  if (!_replying)
+    return;
+  _replying = false;
+  _inFrame = false;
+  uint8_t flags = _replyTagged ? FrameFlags::Tagged : 0;
+  size_t size = _reply.size() - FrameHeaderSize;
+  if (_replyCompression != Compression::None && MinCompressedSize <= size) {
+    uint32_t expanded = htonl(size);
+    _scratch.assign(FrameHeaderSize, 0);
+    _scratch.insert(_scratch.end(), (const uint8_t*) &expanded, (const uint8_t*) &expanded + sizeof(uint32_t));
+    _compressor.compress(_replyCompression, _reply.data() + FrameHeaderSize, size, _scratch);
+    if (_scratch.size() < _reply.size()) {
+      _reply.swap(_scratch);
+      flags |= FrameFlags::Compressed;
+    }
+  }
+  uint32_t length = htonl(_reply.size() - FrameHeaderSize);
+  _reply[0] = _replyOperation;
+  _reply[1] = flags;
+  memcpy(_reply.data() + 2, &length, sizeof(uint32_t));
+  uint32_t crc = digest(_replyChecksum, 0, _reply.data(), _reply.size());
+  transmit(_reply.data(), _reply.size());
+  if (_replyChecksum == Checksum::CRC32C)
+    writeUInt32(crc);
+  else
+    writeUInt16((uint16_t) crc);
+}
+
+void TCPHandler::beginMessage() {
+  _message.clear();
+  _messageBegin = _frameBegin;
+}
+
+size_t TCPHandler::take(size_t size) {
+  if (_inFrame) {
+    if (_frame.size() - _frameBegin < size)
+      throw TransmissionErrorException("Not enough data in the frame", 0);
+    size_t offset = _frameBegin - _messageBegin;
+    _frameBegin += size;
+    return offset;
+  }
+  size_t offset = _message.size();
+  _message.resize(offset + size);
+  receive(_message.data() + offset, size);
+  return offset;
+}
+
+uint32_t TCPHandler::messageChecksum() const {
+  if (_inFrame)
+    return 0;
+  return digest(_checksum, 0, _message.data(), _message.size());
+}
+
+void TCPHandler::writeMessage(const void *ptr, size_t size) {
+  transmit(ptr, size);
+  if (!_replying)
+    writeChecksum(digest(_checksum, 0, ptr, size));
+}
+
+uint8_t TCPHandler::readUInt8(uint8_t max) {
+  uint8_t value;
+  receive(&value, sizeof(uint8_t));
   if (max && max < value) {
     throw TransmissionErrorException("Message size to big wanted " + std::to_string(max) + " readed " + std::to_string(value), 0);
   }
   return value;
 }
 
-uint8_t TCPHandler::readUInt8C(uint16_t &crc, uint8_t max) {
-  SocketWatcher::Watcher watcher(_socket);
+uint8_t TCPHandler::readUInt8C(uint32_t &crc, uint8_t max) {
   uint8_t value;
-  if (sizeof(uint8_t) != read(_socket, &value, sizeof(uint8_t))) {
-    throw TransmissionErrorException("Not enough data in the buffer", 0);
-  }
-  crc = update_crc_16(crc, value);
+  receive(&value, sizeof(uint8_t));
+  update(crc, &value, sizeof(value));
   if (max && max < value) {
     throw TransmissionErrorException("Message size to big wanted " + std::to_string(max) + " readed " + std::to_string(value), 0);
   }
@@ -133,11 +430,8 @@ uint8_t TCPHandler::readUInt8C(uint16_t &crc, uint8_t max) {
 }
 
 uint16_t TCPHandler::readUInt16(uint16_t max) {
-  SocketWatcher::Watcher watcher(_socket);
   uint16_t value;
-  if (sizeof(uint16_t) != read(_socket, &value, sizeof(uint16_t))) {
-    throw TransmissionErrorException("Not enough data in the buffer", 0);
-  }
+  receive(&value, sizeof(uint16_t));
   value = ntohs(value);
   if (max && max < value) {
     throw TransmissionErrorException("Message size to big wanted " + std::to_string(max) + " readed " + std::to_string(value), 0);
@@ -145,15 +439,10 @@ uint16_t TCPHandler::readUInt16(uint16_t max) {
   return value;
 }
 
-uint16_t TCPHandler::readUInt16C(uint16_t &crc, uint16_t max) {
-  SocketWatcher::Watcher watcher(_socket);
+uint16_t TCPHandler::readUInt16C(uint32_t &crc, uint16_t max) {
   uint16_t value;
-  if (sizeof(uint16_t) != read(_socket, &value, sizeof(uint16_t))) {
-    throw TransmissionErrorException("Not enough data in the buffer", 0);
-  }
-  uint8_t *ptr = (uint8_t*) &value;
-  for (unsigned int i = 0; i < sizeof(value); i++)
-    crc = update_crc_16(crc, (unsigned char) *ptr++);
+  receive(&value, sizeof(uint16_t));
+  update(crc, &value, sizeof(value));
   value = ntohs(value);
   if (max && max < value) {
     throw TransmissionErrorException("Message size to big wanted " + std::to_string(max) + " readed " + std::to_string(value), 0);
@@ -162,11 +451,8 @@ uint16_t TCPHandler::readUInt16C(uint16_t &crc, uint16_t max) {
 }
 
 uint32_t TCPHandler::readUInt32(uint32_t max) {
-  SocketWatcher::Watcher watcher(_socket);
   uint32_t value;
-  if (sizeof(uint32_t) != read(_socket, &value, sizeof(uint32_t))) {
-    throw TransmissionErrorException("Not enough data in the buffer", 0);
-  }
+  receive(&value, sizeof(uint32_t));
   value = ntohl(value);
   if (max && max < value) {
     throw TransmissionErrorException("Message size to big wanted " + std::to_string(max) + " readed " + std::to_string(value), 0);
@@ -174,15 +460,10 @@ uint32_t TCPHandler::readUInt32(uint32_t max) {
   return value;
 }
 
-uint32_t TCPHandler::readUInt32C(uint16_t &crc, uint32_t max) {
-  SocketWatcher::Watcher watcher(_socket);
+uint32_t TCPHandler::readUInt32C(uint32_t &crc, uint32_t max) {
   uint32_t value;
-  if (sizeof(uint32_t) != read(_socket, &value, sizeof(uint32_t))) {
-    throw TransmissionErrorException("Not enough data in the buffer", 0);
-  }
-  uint8_t *ptr = (uint8_t*) &value;
-  for (unsigned int i = 0; i < sizeof(value); i++)
-    crc = update_crc_16(crc, (unsigned char) *ptr++);
+  receive(&value, sizeof(uint32_t));
+  update(crc, &value, sizeof(value));
   value = ntohl(value);
   if (max && max < value) {
     throw TransmissionErrorException("Message size to big wanted " + std::to_string(max) + " readed " + std::to_string(value), 0);
@@ -191,11 +472,8 @@ uint32_t TCPHandler::readUInt32C(uint16_t &crc, uint32_t max) {
 }
 
 uint64_t TCPHandler::readUInt64(uint64_t max) {
-  SocketWatcher::Watcher watcher(_socket);
   uint64_t value;
-  if (sizeof(uint64_t) != read(_socket, &value, sizeof(uint64_t))) {
-    throw TransmissionErrorException("Not enough data in the buffer", 0);
-  }
+  receive(&value, sizeof(uint64_t));
   value = ntohll(value);
   if (max && max < value) {
     throw TransmissionErrorException("Message size to big wanted " + std::to_string(max) + " readed " + std::to_string(value), 0);
@@ -203,15 +481,10 @@ uint64_t TCPHandler::readUInt64(uint64_t max) {
   return value;
 }
 
-uint64_t TCPHandler::readUInt64C(uint16_t &crc, uint64_t max) {
-  SocketWatcher::Watcher watcher(_socket);
+uint64_t TCPHandler::readUInt64C(uint32_t &crc, uint64_t max) {
   uint64_t value;
-  if (sizeof(uint64_t) != read(_socket, &value, sizeof(uint64_t))) {
-    throw TransmissionErrorException("Not enough data in the buffer", 0);
-  }
-  uint8_t *ptr = (uint8_t*) &value;
-  for (unsigned int i = 0; i < sizeof(value); i++)
-    crc = update_crc_16(crc, (unsigned char) *ptr++);
+  receive(&value, sizeof(uint64_t));
+  update(crc, &value, sizeof(value));
   value = ntohll(value);
   if (max && max < value) {
     throw TransmissionErrorException("Message size to big wanted " + std::to_string(max) + " readed " + std::to_string(value), 0);
@@ -220,127 +493,102 @@ uint64_t TCPHandler::readUInt64C(uint16_t &crc, uint64_t max) {
 }
 
 void TCPHandler::readChar(char *ptr, ssize_t size) {
-  SocketWatcher::Watcher watcher(_socket);
-  if (size != 0 && size != read(_socket, ptr, size)) {
-    throw TransmissionErrorException("Not enough data in the buffer", 0);
-  }
+  receive(ptr, size);
 }
 
-void TCPHandler::readCharC(char *ptr, ssize_t size, uint16_t &crc) {
-  SocketWatcher::Watcher watcher(_socket);
-  if (size != 0 && size != read(_socket, ptr, size)) {
-    throw TransmissionErrorException("Not enough data in the buffer", 0);
-  }
-  for (unsigned int i = 0; i < size; i++)
-    crc = update_crc_16(crc, (unsigned char) *ptr++);
+void TCPHandler::readCharC(char *ptr, ssize_t size, uint32_t &crc) {
+  receive(ptr, size);
+  update(crc, ptr, size);
 }
 
 void TCPHandler::readUUID(char *ptr) {
-  SocketWatcher::Watcher watcher(_socket);
-  if (36 != read(_socket, ptr, 36)) {
-    throw TransmissionErrorException("Not enough data in the buffer", 0);
-  }
+  receive(ptr, 36);
 }
 
-void TCPHandler::readUUIDC(char *ptr, uint16_t &crc) {
-  SocketWatcher::Watcher watcher(_socket);
-  if (36 != read(_socket, ptr, 36)) {
-    throw TransmissionErrorException("Not enough data in the buffer", 0);
+void TCPHandler::readUUIDC(char *ptr, uint32_t &crc) {
+  receive(ptr, 36);
+  update(crc, ptr, 36);
+}
+
+uint32_t TCPHandler::readChecksum() {
+  if (_inFrame) {
+    if (_frameBegin != _frame.size())
+      throw TransmissionErrorException("Unexpected data at the end of the frame", 0);
+    return 0;
   }
-  for (unsigned int i = 0; i < 36; i++)
-    crc = update_crc_16(crc, (unsigned char) *ptr++);
+  if (_checksum == Checksum::CRC32C)
+    return readUInt32();
+  else
+    return readUInt16();
+}
+
+void TCPHandler::writeChecksum(uint32_t crc) {
+  if (_replying)
+    return;
+  if (_checksum == Checksum::CRC32C)
+    writeUInt32(crc);
+  else
+    writeUInt16((uint16_t) crc);
 }
 
 void TCPHandler::writeUInt8(uint8_t value) {
-  if (sizeof(uint8_t) != write(_socket, &value, sizeof(uint8_t))) {
-    throw TransmissionErrorException("Network error while writing output data", 0);
-  }
+  transmit(&value, sizeof(uint8_t));
 }
 
-void TCPHandler::writeUInt8C(uint8_t value, uint16_t &crc) {
-  if (sizeof(uint8_t) != write(_socket, &value, sizeof(uint8_t))) {
-    throw TransmissionErrorException("Network error while writing output data", 0);
-  }
-  crc = update_crc_16(crc, value);
+void TCPHandler::writeUInt8C(uint8_t value, uint32_t &crc) {
+  transmit(&value, sizeof(uint8_t));
+  update(crc, &value, sizeof(value));
 }
 
 void TCPHandler::writeUInt16(uint16_t value) {
   value = htons(value);
-  if (sizeof(uint16_t) != write(_socket, &value, sizeof(uint16_t))) {
-    throw TransmissionErrorException("Network error while writing output data", 0);
-  }
+  transmit(&value, sizeof(uint16_t));
 }
 
-void TCPHandler::writeUInt16C(uint16_t value, uint16_t &crc) {
+void TCPHandler::writeUInt16C(uint16_t value, uint32_t &crc) {
   value = htons(value);
-  if (sizeof(uint16_t) != write(_socket, &value, sizeof(uint16_t))) {
-    throw TransmissionErrorException("Network error while writing output data", 0);
-  }
-  uint8_t *ptr = (uint8_t*) &value;
-  for (unsigned int i = 0; i < sizeof(value); i++)
-    crc = update_crc_16(crc, (unsigned char) *ptr++);
+  transmit(&value, sizeof(uint16_t));
+  update(crc, &value, sizeof(value));
 }
 
 void TCPHandler::writeUInt32(uint32_t value) {
   value = htonl(value);
-  if (sizeof(uint32_t) != write(_socket, &value, sizeof(uint32_t))) {
-    throw TransmissionErrorException("Network error while writing output data", 0);
-  }
+  transmit(&value, sizeof(uint32_t));
 }
 
-void TCPHandler::writeUInt32C(uint32_t value, uint16_t &crc) {
+void TCPHandler::writeUInt32C(uint32_t value, uint32_t &crc) {
   value = htonl(value);
-  if (sizeof(uint32_t) != write(_socket, &value, sizeof(uint32_t))) {
-    throw TransmissionErrorException("Network error while writing output data", 0);
-  }
-  uint8_t *ptr = (uint8_t*) &value;
-  for (unsigned int i = 0; i < sizeof(value); i++)
-    crc = update_crc_16(crc, (unsigned char) *ptr++);
+  transmit(&value, sizeof(uint32_t));
+  update(crc, &value, sizeof(value));
 }
 
 void TCPHandler::writeUInt64(uint64_t value) {
   value = htonll(value);
-  if (sizeof(uint64_t) != write(_socket, &value, sizeof(uint64_t))) {
-    throw TransmissionErrorException("Network error while writing output data", 0);
-  }
+  transmit(&value, sizeof(uint64_t));
 }
 
-void TCPHandler::writeUInt64C(uint64_t value, uint16_t &crc) {
+void TCPHandler::writeUInt64C(uint64_t value, uint32_t &crc) {
   value = htonll(value);
-  if (sizeof(uint64_t) != write(_socket, &value, sizeof(uint64_t))) {
-    throw TransmissionErrorException("Network error while writing output data", 0);
-  }
-  uint8_t *ptr = (uint8_t*) &value;
-  for (unsigned int i = 0; i < sizeof(value); i++)
-    crc = update_crc_16(crc, (unsigned char) *ptr++);
+  transmit(&value, sizeof(uint64_t));
+  update(crc, &value, sizeof(value));
 }
 
 void TCPHandler::writeChar(const char *ptr, ssize_t size) {
-  if (size != 0 && size != write(_socket, ptr, size)) {
-    throw TransmissionErrorException("Network error while writing output data", 0);
-  }
+  transmit(ptr, size);
 }
 
-void TCPHandler::writeCharC(const char *ptr, ssize_t size, uint16_t &crc) {
-  if (size != 0 && size != write(_socket, ptr, size)) {
-    throw TransmissionErrorException("Network error while writing output data", 0);
-  }
-  for (unsigned int i = 0; i < size; i++)
-    crc = update_crc_16(crc, (unsigned char) *ptr++);
+void TCPHandler::writeCharC(const char *ptr, ssize_t size, uint32_t &crc) {
+  transmit(ptr, size);
+  update(crc, ptr, size);
 }
 
 void TCPHandler::writeUUID(const char *ptr) {
-  if (36 != write(_socket, ptr, 36)) {
-    throw TransmissionErrorException("Network error while writing output data", 0);
-  }
+  transmit(ptr, 36);
 }
 
-void TCPHandler::writeUUIDC(const char *ptr, uint16_t &crc) {
-  if (36 != write(_socket, ptr, 36)) {
-    throw TransmissionErrorException("Network error while writing output data", 0);
-  }
-  for (unsigned int i = 0; i < 36; i++)
-    crc = update_crc_16(crc, (unsigned char) *ptr++);
+void TCPHandler::writeUUIDC(const char *ptr, uint32_t &crc) {
+  transmit(ptr, 36);
+  update(crc, ptr, 36);
 }
 
 } /* namespace TCP */
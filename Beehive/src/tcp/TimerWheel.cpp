@@ -0,0 +1,135 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <tcp/TimerWheel.hpp>
+
+namespace Beehive {
+namespace Services {
+namespace TCP {
+
+TimerWheel::TimerWheel(std::chrono::milliseconds resolution) :
+    _resolution(resolution), _start(std::chrono::steady_clock::now()), _current(0), _count(0) {
+  for (int level = 0; level < Levels; level++) {
+    for (uint64_t slot = 0; slot < Slots; slot++) {
+      _slots[level][slot]._next = &_slots[level][slot];
+      _slots[level][slot]._prev = &_slots[level][slot];
+    }
+  }
+}
+
+uint64_t TimerWheel::ticks() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start) / _resolution;
+}
+
+void TimerWheel::schedule(Timer *timer, std::chrono::milliseconds timeout) {
+  if (timer->scheduled())
+    unlink(timer);
+  else
+    _count++;
+  uint64_t expires = ticks() + (timeout + _resolution - std::chrono::milliseconds(1)) / _resolution;
+  timer->_expires = expires <= _current ? _current + 1 : expires;
+  place(timer);
+}
+
+void TimerWheel::cancel(Timer *timer) {
+  if (timer->scheduled()) {
+    unlink(timer);
+    _count--;
+  }
+}
+
+void TimerWheel::place(Timer *timer) {
+  int level = 0;
+  while (level < Levels - 1 && Slots <= (timer->_expires >> (level * SlotBits)) - (_current >> (level * SlotBits)))
+    level++;
+  Timer *head = &_slots[level][(timer->_expires >> (level * SlotBits)) & SlotMask];
+  timer->_next = head;
+  timer->_prev = head->_prev;
+  head->_prev->_next = timer;
+  head->_prev = timer;
+}
+
+void TimerWheel::unlink(Timer *timer) {
+  timer->_prev->_next = timer->_next;
+  timer->_next->_prev = timer->_prev;
+  timer->_next = nullptr;
+  timer->_prev = nullptr;
+}
+
+int TimerWheel::timeout() {
+  if (_count == 0)
+    return -1;
+  uint64_t now = ticks();
+  uint64_t tick = _current + 1;
+  while ((tick & SlotMask) != 0) {
+    Timer *head = &_slots[0][tick & SlotMask];
+    if (head->_next != head)
+      break;
+    tick++;
+  }
+  if (tick <= now)
+    return 0;
+  std::chrono::milliseconds wait = (tick - now) * _resolution;
+  return (int) wait.count();
+}
+
+TimerWheel::Timer* TimerWheel::advance() {
+  Timer *expired = nullptr;
+  uint64_t now = ticks();
+  while (_current < now && 0 < _count) {
+    _current++;
+    for (int level = 1; level < Levels && (_current & ((1ull << (level * SlotBits)) - 1)) == 0; level++) {
+      Timer *head = &_slots[level][(_current >> (level * SlotBits)) & SlotMask];
+      Timer *timer = head->_next;
+      head->_next = head;
+      head->_prev = head;
+      while (timer != head) {
+        Timer *next = timer->_next;
+        place(timer);
+        timer = next;
+      }
+    }
+    Timer *head = &_slots[0][_current & SlotMask];
+    Timer *timer = head->_next;
+    head->_next = head;
+    head->_prev = head;
+    while (timer != head) {
+      Timer *next = timer->_next;
+      timer->_prev = nullptr;
+      timer->_next = expired;
+      expired = timer;
+      _count--;
+      timer = next;
+    }
+  }
+  if (_current < now)
+    _current = now;
+  return expired;
+}
+
+} /* namespace TCP */
+} /* namespace Services */
+} /* namespace Beehive */
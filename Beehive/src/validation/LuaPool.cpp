@@ -0,0 +1,138 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <validation/LuaPool.hpp>
+
+#include <validation/TransactionsManager.hpp>
+#include <nanolog/NanoLog.hpp>
+
+namespace Beehive {
+namespace Services {
+namespace Utils {
+
+LuaPool::State::State(const std::shared_ptr<Config::Context> &context) :
+    lua(sol::c_call<decltype(&onPanic), &onPanic>), context(context), owner(nullptr) {
+  lua.open_libraries(sol::lib::table, sol::lib::string, sol::lib::math, sol::lib::base);
+  LuaRowSet::define(lua);
+  lua.set_function("log", [](std::string message) {
+    LOG_INFO << message;
+  });
+
+  lua.set_function("read", [this](std::string entity, sol::table data) {
+    return owner->readEntity(entity, data);
+  });
+
+  lua.set_function("save", [this](std::string entity, sol::table data) {
+    return owner->saveEntity(entity, data);
+  });
+
+  lua.set_function("update", [this](std::string entity, sol::table data) {
+    return owner->updateEntity(entity, data);
+  });
+
+  lua.set_function("remove", [this](std::string entity, sol::table key) {
+    return owner->removeEntity(entity, key);
+  });
+
+  for (auto &transaction : context->transactions) {
+    if (!transaction.second.preBytecode.empty())
+      load(onValidation, transaction.second.uuid, transaction.second.preBytecode);
+    if (!transaction.second.postBytecode.empty())
+      load(onCommit, transaction.second.uuid, transaction.second.postBytecode);
+  }
+}
+
+const LuaPool::State::Names& LuaPool::State::names(const Config::Entity &entity) {
+  auto namesPtr = _names.find(&entity);
+  if (namesPtr != _names.end())
+    return namesPtr->second;
+  lua_State *L = lua.lua_state();
+  Names names;
+  lua_pushlstring(L, entity.name.data(), entity.name.size());
+  names.entity = luaL_ref(L, LUA_REGISTRYINDEX);
+  lua_createtable(L, 0, entity.keys.size());
+  for (auto &key : entity.keys) {
+    lua_pushlstring(L, key.second.name.data(), key.second.name.size());
+    lua_rawseti(L, -2, key.first);
+  }
+  names.keys = luaL_ref(L, LUA_REGISTRYINDEX);
+  lua_createtable(L, 0, entity.attributes.size());
+  for (auto &attribute : entity.attributes) {
+    lua_pushlstring(L, attribute.second.name.data(), attribute.second.name.size());
+    lua_rawseti(L, -2, attribute.first);
+  }
+  names.attributes = luaL_ref(L, LUA_REGISTRYINDEX);
+  return _names.emplace(&entity, names).first->second;
+}
+
+void LuaPool::State::load(std::unordered_map<std::string, sol::protected_function, IHasher, IEqualsComparator> &functions, const std::string &transaction, const std::string &bytecode) {
+  sol::load_result result = lua.load(bytecode, transaction, sol::load_mode::binary);
+  if (!result.valid()) {
+    sol::error err = result;
+    LOG_WARN << "Failed to load script " << transaction << " " << err.what();
+    return;
+  }
+  functions.emplace(transaction, result.get<sol::protected_function>());
+}
+
+LuaPool::State& LuaPool::acquire(const std::shared_ptr<Config::Context> &context, TransactionsManager *owner) {
+  thread_local std::unordered_map<const Config::Context*, std::unique_ptr<State>> states;
+  auto statePtr = states.find(context.get());
+  if (statePtr == states.end() || statePtr->second->context.lock() != context) {
+    if (statePtr != states.end())
+      states.erase(statePtr);
+    if (states.size() >= MaxStates) {
+      for (auto it = states.begin(); it != states.end();) {
+        if (it->second->context.expired())
+          it = states.erase(it);
+        else
+          ++it;
+      }
+      if (states.size() >= MaxStates)
+        states.erase(states.begin());
+    }
+    statePtr = states.emplace(context.get(), std::make_unique<State>(context)).first;
+  }
+  statePtr->second->owner = owner;
+  return *statePtr->second;
+}
+
+std::string LuaPool::compile(const std::string &transaction, const std::string &script) {
+  sol::state lua(sol::c_call<decltype(&onPanic), &onPanic>);
+  sol::load_result result = lua.load(script, transaction);
+  if (!result.valid()) {
+    sol::error err = result;
+    LOG_WARN << "Failed to compile script " << transaction << " " << err.what();
+    return std::string();
+  }
+  sol::protected_function function = result;
+  sol::bytecode bytecode = function.dump();
+  return std::string(bytecode.as_string_view());
+}
+
+} /* namespace Utils */
+} /* namespace Services */
+} /* namespace Beehive */
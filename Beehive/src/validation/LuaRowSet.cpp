@@ -0,0 +1,103 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <validation/LuaRowSet.hpp>
+
+#include <uuid/uuid.h>
+
+namespace Beehive {
+namespace Services {
+namespace Utils {
+
+static sol::object decode(lua_State *L, const std::string &buffer, int id) {
+  SqLite::BinaryDecoder decoder(buffer.data(), buffer.size());
+  for (SqLite::BinaryDecoder::Value &value : decoder) {
+    if (value.id() != id)
+      continue;
+    switch (value.type()) {
+      case SqLite::AttributeType::Integer:
+        return sol::make_object(L, value.integerValue());
+      case SqLite::AttributeType::Real:
+        return sol::make_object(L, value.realValue());
+      case SqLite::AttributeType::Text:
+        return sol::make_object(L, value.textValue());
+      case SqLite::AttributeType::Blob:
+        return sol::make_object(L, value.blobValue());
+      case SqLite::AttributeType::UuidV1:
+      case SqLite::AttributeType::UuidV4: {
+        char plain[37];
+        uuid_unparse_lower((const unsigned char*) value.uuidValue().c_str(), plain);
+        return sol::make_object(L, std::string(plain, 36));
+      }
+      default:
+        return sol::lua_nil;
+    }
+  }
+  return sol::lua_nil;
+}
+
+sol::object LuaRowSet::Row::get(std::string_view name, sol::this_state state) const {
+  const Entities::KeyData &keyData = (*_rows)[_index];
+  int id = _entity->keysCodec.find(name);
+  if (id >= 0)
+    return decode(state, keyData.oldPK(), id);
+  id = _entity->attributesCodec.find(name);
+  if (id >= 0)
+    return decode(state, keyData.oldData(), id);
+  return sol::lua_nil;
+}
+
+sol::object LuaRowSet::row(sol::stack_object index, sol::this_state state) const {
+  if (index.get_type() != sol::type::number)
+    return sol::lua_nil;
+  lua_Integer position = index.as<lua_Integer>();
+  if (position < 1 || static_cast<size_t>(position) > _rows->size())
+    return sol::lua_nil;
+  return sol::make_object(state, Row(_rows, position - 1, _entity));
+}
+
+std::tuple<sol::object, sol::object> LuaRowSet::next(sol::object control, sol::this_state state) const {
+  lua_Integer position = control.is<lua_Integer>() ? control.as<lua_Integer>() : 0;
+  if (position < 0 || static_cast<size_t>(position) >= _rows->size())
+    return std::make_tuple(sol::object(sol::lua_nil), sol::object(sol::lua_nil));
+  return std::make_tuple(sol::make_object(state, position + 1), sol::make_object(state, Row(_rows, position, _entity)));
+}
+
+void LuaRowSet::define(sol::state &lua) {
+  lua.new_usertype<Row>("Row", sol::no_constructor,
+      sol::meta_function::index, &Row::get);
+  lua.new_usertype<LuaRowSet>("RowSet", sol::no_constructor,
+      sol::meta_function::index, &LuaRowSet::row,
+      sol::meta_function::length, &LuaRowSet::size,
+      sol::meta_function::pairs, [](sol::stack_object rows, sol::this_state state) {
+        return std::make_tuple(sol::make_object(state, &LuaRowSet::next), sol::object(rows), sol::object(sol::lua_nil));
+      });
+}
+
+} /* namespace Utils */
+} /* namespace Services */
+} /* namespace Beehive */
@@ -27,126 +27,43 @@ SOFTWARE.
 
 #include <validation/TransactionsManager.hpp>
 
-#include <uuid/uuid.h>
 #include <nanolog/NanoLog.hpp>
 
 namespace Beehive {
 namespace Services {
 namespace Utils {
 
-sol::table TransactionsManager::readEntity(std::string entity, sol::table key) {
-    sol::table result = _lua.create_table();
+LuaRowSet TransactionsManager::readEntity(std::string entity, sol::table key) {
     auto idPtr = _context->entitiesName2UUID.find(entity);
     if (idPtr == _context->entitiesName2UUID.end()) {
         LOG_ERROR << "Entity " << entity << " not found";
-        return 0;
+        return LuaRowSet(std::vector<Entities::KeyData>(), nullptr);
     }
     const auto &entityPtr = _context->entities.find(idPtr->second);
     if (entityPtr == _context->entities.end()) {
         LOG_ERROR << "Entity " << entity << " not found";
-        return result;
+        return LuaRowSet(std::vector<Entities::KeyData>(), nullptr);
     }
     Config::Entity &ent = entityPtr->second;
-    if (key.size() == 0) {
-        int index = 1;
-        std::vector<Entities::KeyData> keyDataV = _entityDAO->read(_lua.get<uint32_t>("idDataset"), key, ent, _context->uuid);
-        for (Entities::KeyData keyData : keyDataV) {
-            SqLite::BinaryDecoder oldPK(keyData.oldPK().data(), keyData.oldPK().size());
-            SqLite::BinaryDecoder oldData(keyData.oldData().data(), keyData.oldData().size());
-            result[index] = _lua.create_table();
-            for (SqLite::BinaryDecoder::Value &value : oldPK) {
-                auto keyPtr = ent.keys.find(value.id());
-                if (keyPtr != ent.keys.end())
-                    switch (value.type()) {
-                        case SqLite::AttributeType::Integer:
-                            result[index][keyPtr->second.name] = value.integerValue();
-                            break;
-                        case SqLite::AttributeType::Text:
-                            result[index][keyPtr->second.name] = value.textValue();
-                            break;
-                        case SqLite::AttributeType::Blob:
-                            result[index][keyPtr->second.name] = value.blobValue();
-                            break;
-                    }
-            }
-            for (SqLite::BinaryDecoder::Value &value : oldData) {
-                auto attributePtr = ent.attributes.find(value.id());
-                if (attributePtr != ent.attributes.end())
-                    switch (value.type()) {
-                        case SqLite::AttributeType::Integer:
-                            result[index][attributePtr->second.name] = value.integerValue();
-                            break;
-                        case SqLite::AttributeType::Real:
-                            result[index][attributePtr->second.name] = value.realValue();
-                            break;
-                        case SqLite::AttributeType::Text:
-                            result[index][attributePtr->second.name] = value.textValue();
-                            break;
-                        case SqLite::AttributeType::Blob:
-                            result[index][attributePtr->second.name] = value.blobValue();
-                            break;
-                        case SqLite::AttributeType::UuidV1:
-                            char plain[37];
-                            uuid_unparse_lower((const unsigned char *)value.uuidValue().c_str(), plain);
-                            result[index][attributePtr->second.name] = std::string(plain, 16);
-                            break;
-                    }
-            }
-            index++;
-        }
-    } else {
-        int index = 1;
-        for (size_t i = 1; i <= entity.size(); i++) {
-            sol::object rdata = key[i];
-            if (rdata.get_type() == sol::type::table) {
-                sol::table inner = rdata.as<sol::table>();
-                std::vector<Entities::KeyData> keyDataV = _entityDAO->read(_lua.get<uint32_t>("idDataset"), inner, ent, _context->uuid);
-                for (Entities::KeyData keyData : keyDataV) {
-                    SqLite::BinaryDecoder oldPK(keyData.oldPK().data(), keyData.oldPK().size());
-                    SqLite::BinaryDecoder oldData(keyData.oldData().data(), keyData.oldData().size());
-                    result[index] = _lua.create_table();
-                    for (SqLite::BinaryDecoder::Value &value : oldPK) {
-                        auto keyPtr = ent.keys.find(value.id());
-                        if (keyPtr != ent.keys.end())
-                            switch (value.type()) {
-                                case SqLite::AttributeType::Integer:
-                                    result[index][keyPtr->second.name] = value.integerValue();
-                                    break;
-                                case SqLite::AttributeType::Text:
-                                    result[index][keyPtr->second.name] = value.textValue();
-                                    break;
-                                case SqLite::AttributeType::Blob:
-                                    result[index][keyPtr->second.name] = value.blobValue();
-                                    break;
-                            }
-                    }
-                    for (SqLite::BinaryDecoder::Value &value : oldData) {
-                        auto attributePtr = ent.attributes.find(value.id());
-                        if (attributePtr != ent.attributes.end())
-                            switch (value.type()) {
-                                case SqLite::AttributeType::Integer:
-                                    result[index][attributePtr->second.name] = value.integerValue();
-                                    break;
-                                case SqLite::AttributeType::Real:
-                                    result[index][attributePtr->second.name] = value.realValue();
-                                    break;
-                                case SqLite::AttributeType::Text:
-                                    result[index][attributePtr->second.name] = value.textValue();
-                                    break;
-                                case SqLite::AttributeType::Blob:
-                                    result[index][attributePtr->second.name] = value.blobValue();
-                                    break;
-                            }
-                    }
-                    index++;
-                }
-            }
+    if (key.size() == 0)
+        return LuaRowSet(_entityDAO->read(_state->lua.get<uint32_t>("idDataset"), key, ent, _handle), &ent);
+    std::vector<Entities::KeyData> rows;
+    for (size_t i = 1; i <= key.size(); i++) {
+        sol::object rdata = key[i];
+        if (rdata.get_type() == sol::type::table) {
+            sol::table inner = rdata.as<sol::table>();
+            std::vector<Entities::KeyData> keyDataV = _entityDAO->read(_state->lua.get<uint32_t>("idDataset"), inner, ent, _handle);
+            rows.insert(rows.end(), std::make_move_iterator(keyDataV.begin()), std::make_move_iterator(keyDataV.end()));
         }
     }
-    return result;
+    return LuaRowSet(std::move(rows), &ent);
 }
 
 int TransactionsManager::saveEntity(std::string entity, sol::table data) {
+    if (!_batch) {
+        LOG_ERROR << "Entity " << entity << " written outside of a header";
+        return 0;
+    }
     auto idPtr = _context->entitiesName2UUID.find(entity);
     if (idPtr == _context->entitiesName2UUID.end()) {
         LOG_ERROR << "Entity " << entity << " not found";
@@ -159,14 +76,14 @@ int TransactionsManager::saveEntity(std::string entity, sol::table data) {
     }
     Config::Entity &ent = entityPtr->second;
     if (data.size() == 0) {
-        return _entityDAO->save(_lua.get<uint32_t>("idDataset"), data, ent, _context->uuid);
+        return _entityDAO->save(_state->lua.get<uint32_t>("idDataset"), data, ent, _handle, *_batch);
     } else {
         int total = 0;
         for (size_t i = 1; i <= entity.size(); i++) {
             sol::object rdata = data[i];
             if (rdata.get_type() == sol::type::table) {
                 sol::table inner = rdata.as<sol::table>();
-                total += _entityDAO->save(_lua.get<uint32_t>("idDataset"), inner, ent, _context->uuid);
+                total += _entityDAO->save(_state->lua.get<uint32_t>("idDataset"), inner, ent, _handle, *_batch);
             }
         }
         return total;
@@ -174,6 +91,10 @@ int TransactionsManager::saveEntity(std::string entity, sol::table data) {
 }
 
 int TransactionsManager::updateEntity(std::string entity, sol::table data) {
+    if (!_batch) {
+        LOG_ERROR << "Entity " << entity << " written outside of a header";
+        return 0;
+    }
     auto idPtr = _context->entitiesName2UUID.find(entity);
     if (idPtr == _context->entitiesName2UUID.end()) {
         LOG_ERROR << "Entity " << entity << " not found";
@@ -194,7 +115,7 @@ int TransactionsManager::updateEntity(std::string entity, sol::table data) {
             sol::table innerKey = keyData.as<sol::table>();
             sol::table innerData = dataData.as<sol::table>();
             if (innerKey.size() == 0 && innerData.size() == 0) {
-                return _entityDAO->update(_lua.get<uint32_t>("idDataset"), innerKey, innerData, ent, _context->uuid);
+                return _entityDAO->update(_state->lua.get<uint32_t>("idDataset"), innerKey, innerData, ent, _handle, *_batch);
             }
         }
     }
@@ -210,7 +131,7 @@ int TransactionsManager::updateEntity(std::string entity, sol::table data) {
                     sol::table innerKey = keyData.as<sol::table>();
                     sol::table innerData = dataData.as<sol::table>();
                     if (innerKey.size() == 0 && innerData.size() == 0) {
-                        total += _entityDAO->update(_lua.get<uint32_t>("idDataset"), innerKey, innerData, ent, _context->uuid);
+                        total += _entityDAO->update(_state->lua.get<uint32_t>("idDataset"), innerKey, innerData, ent, _handle, *_batch);
                     } else {
                         LOG_ERROR << "Invalid inner array size index " << i;
                     }
@@ -226,6 +147,10 @@ int TransactionsManager::updateEntity(std::string entity, sol::table data) {
 }
 
 int TransactionsManager::removeEntity(std::string entity, sol::table key) {
+    if (!_batch) {
+        LOG_ERROR << "Entity " << entity << " written outside of a header";
+        return 0;
+    }
     auto idPtr = _context->entitiesName2UUID.find(entity);
     if (idPtr == _context->entitiesName2UUID.end()) {
         LOG_ERROR << "Entity " << entity << " not found";
@@ -238,14 +163,14 @@ int TransactionsManager::removeEntity(std::string entity, sol::table key) {
     }
     Config::Entity &ent = entityPtr->second;
     if (key.size() == 0) {
-           return _entityDAO->remove(_lua.get<uint32_t>("idDataset"), key, ent, _context->uuid);
+           return _entityDAO->remove(_state->lua.get<uint32_t>("idDataset"), key, ent, _handle, *_batch);
     } else {
         int total = 0;
         for (size_t i = 1; i <= entity.size(); i++) {
             sol::object rdata = key[i];
             if (rdata.get_type() == sol::type::table) {
                 sol::table inner = rdata.as<sol::table>();
-                total += _entityDAO->remove(_lua.get<uint32_t>("idDataset"), inner, ent, _context->uuid);
+                total += _entityDAO->remove(_state->lua.get<uint32_t>("idDataset"), inner, ent, _handle, *_batch);
             }
         }
         return total;
@@ -253,210 +178,113 @@ int TransactionsManager::removeEntity(std::string entity, sol::table key) {
     return 0;
 }
 
-void TransactionsManager::loadValidation(std::string transaction, std::string script) {
-    _onValidation[transaction] = _lua.load(script);
-    if (!_onValidation[transaction].valid()) {
-        sol::error err = _onValidation[transaction];
-        LOG_WARN << "Failed to load pre execution script " << transaction << " " << err.what();
-        _onValidation.erase(transaction);
+void TransactionsManager::pushRow(lua_State *L, int record, int names, const std::string_view &data) {
+    SqLite::BinaryDecoder decoder(data.data(), data.size());
+    for (SqLite::BinaryDecoder::Value &value : decoder) {
+        if (lua_rawgeti(L, names, value.id()) != LUA_TSTRING) {
+            lua_pop(L, 1);
+            continue;
+        }
+        switch (value.type()) {
+            case SqLite::AttributeType::Integer:
+                lua_pushinteger(L, value.integerValue());
+                break;
+            case SqLite::AttributeType::Real:
+                lua_pushnumber(L, value.realValue());
+                break;
+            case SqLite::AttributeType::Text: {
+                std::string text = value.textValue();
+                lua_pushlstring(L, text.data(), text.size());
+            } break;
+            case SqLite::AttributeType::Blob: {
+                std::string blob = value.blobValue();
+                lua_pushlstring(L, blob.data(), blob.size());
+            } break;
+            default:
+                lua_pop(L, 1);
+                continue;
+        }
+        lua_rawset(L, record);
     }
 }
 
-void TransactionsManager::loadCommit(std::string transaction, std::string script) {
-    _onCommit[transaction] = _lua.load(script);
-    if (!_onCommit[transaction].valid()) {
-        sol::error err = _onCommit[transaction];
-        LOG_WARN << "Failed to load post execution script " << transaction << " " << err.what();
-        _onCommit.erase(transaction);
-    }
+void TransactionsManager::pushRecord(lua_State *L, const LuaPool::State::Names &names, const Config::Entity &entity, const std::string_view &pk, const std::string_view &data) {
+    lua_createtable(L, 0, entity.keys.size() + entity.attributes.size());
+    int record = lua_gettop(L);
+    lua_rawgeti(L, LUA_REGISTRYINDEX, names.keys);
+    pushRow(L, record, lua_gettop(L), pk);
+    lua_pop(L, 1);
+    lua_rawgeti(L, LUA_REGISTRYINDEX, names.attributes);
+    pushRow(L, record, lua_gettop(L), data);
+    lua_pop(L, 1);
 }
 
-bool TransactionsManager::executeValidation(Entities::Header &header) {
-    auto onValidation = _onValidation.find(header.transactionUUID());
-    auto onCommit = _onCommit.find(header.transactionUUID());
-    if (onValidation != _onValidation.end() || onCommit != _onCommit.end()) {
-        _lua["idDataset"] = header.idDataset();
-        _lua.create_named_table("data");
+bool TransactionsManager::executeValidation(Entities::Header &header, const DAO::Storage::ContextHandle &context, DAO::Storage::Batch &batch) {
+    _state = &LuaPool::acquire(_context, this);
+    _handle = context;
+    _batch = &batch;
+    auto onValidation = _state->onValidation.find(header.transactionUUID());
+    auto onCommit = _state->onCommit.find(header.transactionUUID());
+    if (onValidation != _state->onValidation.end() || onCommit != _state->onCommit.end()) {
+        lua_State *L = _state->lua.lua_state();
+        _state->lua["idDataset"] = header.idDataset();
+        lua_createtable(L, header.changes().size(), 0);
         int index = 1;
-        for (Entities::Change &change : header.changes()) {
-            auto tbl = _context->entities.find(change.entityName());
-            if (tbl != _context->entities.end()) {
-                _lua["data"][index] = _lua.create_table();
-                _lua["data"][index]["entity"] = tbl->second.name;
-                switch (change.operation()) {
-                    case SqLite::Operation::Insert: {
-                        _lua["data"][index]["operation"] = "Add";
-                        SqLite::BinaryDecoder decoderNewPK(change.newPK().data(), change.newPK().size());
-                        _lua["data"][index]["new"] = _lua.create_table();
-                        for (SqLite::BinaryDecoder::Value &value : decoderNewPK) {
-                            auto keyPtr = tbl->second.keys.find(value.id());
-                            if (keyPtr != tbl->second.keys.end())
-                                switch (value.type()) {
-                                    case SqLite::AttributeType::Integer:
-                                        _lua["data"][index]["new"][keyPtr->second.name] = value.integerValue();
-                                        break;
-                                    case SqLite::AttributeType::Text:
-                                        _lua["data"][index]["new"][keyPtr->second.name] = value.textValue();
-                                        break;
-                                    case SqLite::AttributeType::Blob:
-                                        _lua["data"][index]["new"][keyPtr->second.name] = value.blobValue();
-                                        break;
-                                }
-                        }
-                        SqLite::BinaryDecoder decoderNewData(change.newData().data(), change.newData().size());
-                        for (SqLite::BinaryDecoder::Value &value : decoderNewData) {
-                            auto attributePtr = tbl->second.attributes.find(value.id());
-                            if (attributePtr != tbl->second.attributes.end())
-                                switch (value.type()) {
-                                    case SqLite::AttributeType::Integer:
-                                        _lua["data"][index]["new"][attributePtr->second.name] = value.integerValue();
-                                        break;
-                                    case SqLite::AttributeType::Real:
-                                        _lua["data"][index]["new"][attributePtr->second.name] = value.realValue();
-                                        break;
-                                    case SqLite::AttributeType::Text:
-                                        _lua["data"][index]["new"][attributePtr->second.name] = value.textValue();
-                                        break;
-                                    case SqLite::AttributeType::Blob:
-                                        _lua["data"][index]["new"][attributePtr->second.name] = value.blobValue();
-                                        break;
-                                }
-                        }
-                    } break;
-                    case SqLite::Operation::Update: {
-                        _lua["data"][index]["operation"] = "Update";
-                        SqLite::BinaryDecoder decoderNewPK(change.newPK().data(), change.newPK().size());
-                        _lua["data"][index]["new"] = _lua.create_table();
-                        for (SqLite::BinaryDecoder::Value &value : decoderNewPK) {
-                            auto keyPtr = tbl->second.keys.find(value.id());
-                            if (keyPtr != tbl->second.keys.end())
-                                switch (value.type()) {
-                                    case SqLite::AttributeType::Integer:
-                                        _lua["data"][index]["new"][keyPtr->second.name] = value.integerValue();
-                                        break;
-                                    case SqLite::AttributeType::Text:
-                                        _lua["data"][index]["new"][keyPtr->second.name] = value.textValue();
-                                        break;
-                                    case SqLite::AttributeType::Blob:
-                                        _lua["data"][index]["new"][keyPtr->second.name] = value.blobValue();
-                                        break;
-                                }
-                        }
-                        SqLite::BinaryDecoder decoderNewData(change.newData().data(), change.newData().size());
-                        for (SqLite::BinaryDecoder::Value &value : decoderNewData) {
-                            auto attributePtr = tbl->second.attributes.find(value.id());
-                            if (attributePtr != tbl->second.attributes.end())
-                                switch (value.type()) {
-                                    case SqLite::AttributeType::Integer:
-                                        _lua["data"][index]["new"][attributePtr->second.name] = value.integerValue();
-                                        break;
-                                    case SqLite::AttributeType::Real:
-                                        _lua["data"][index]["new"][attributePtr->second.name] = value.realValue();
-                                        break;
-                                    case SqLite::AttributeType::Text:
-                                        _lua["data"][index]["new"][attributePtr->second.name] = value.textValue();
-                                        break;
-                                    case SqLite::AttributeType::Blob:
-                                        _lua["data"][index]["new"][attributePtr->second.name] = value.blobValue();
-                                        break;
-                                }
-                        }
-                        SqLite::BinaryDecoder decoderOldPK(change.oldPK().data(), change.oldPK().size());
-                        _lua["data"][index]["old"] = _lua.create_table();
-                        for (SqLite::BinaryDecoder::Value &value : decoderOldPK) {
-                            auto keyPtr = tbl->second.keys.find(value.id());
-                            if (keyPtr != tbl->second.keys.end())
-                                switch (value.type()) {
-                                    case SqLite::AttributeType::Integer:
-                                        _lua["data"][index]["old"][keyPtr->second.name] = value.integerValue();
-                                        break;
-                                    case SqLite::AttributeType::Text:
-                                        _lua["data"][index]["old"][keyPtr->second.name] = value.textValue();
-                                        break;
-                                    case SqLite::AttributeType::Blob:
-                                        _lua["data"][index]["old"][keyPtr->second.name] = value.blobValue();
-                                        break;
-                                }
-                        }
-                        SqLite::BinaryDecoder decoderOldData(change.oldData().data(), change.oldData().size());
-                        for (SqLite::BinaryDecoder::Value &value : decoderOldData) {
-                            auto attributePtr = tbl->second.attributes.find(value.id());
-                            if (attributePtr != tbl->second.attributes.end())
-                                switch (value.type()) {
-                                    case SqLite::AttributeType::Integer:
-                                        _lua["data"][index]["old"][attributePtr->second.name] = value.integerValue();
-                                        break;
-                                    case SqLite::AttributeType::Real:
-                                        _lua["data"][index]["old"][attributePtr->second.name] = value.realValue();
-                                        break;
-                                    case SqLite::AttributeType::Text:
-                                        _lua["data"][index]["old"][attributePtr->second.name] = value.textValue();
-                                        break;
-                                    case SqLite::AttributeType::Blob:
-                                        _lua["data"][index]["old"][attributePtr->second.name] = value.blobValue();
-                                        break;
-                                }
-                        }
-                    } break;
-                    case SqLite::Operation::Delete: {
-                        _lua["data"][index]["operation"] = "Remove";
-                        SqLite::BinaryDecoder decoderOldPK(change.oldPK().data(), change.oldPK().size());
-                        _lua["data"][index]["old"] = _lua.create_table();
-                        for (SqLite::BinaryDecoder::Value &value : decoderOldPK) {
-                            auto keyPtr = tbl->second.keys.find(value.id());
-                            if (keyPtr != tbl->second.keys.end())
-                                switch (value.type()) {
-                                    case SqLite::AttributeType::Integer:
-                                        _lua["data"][index]["old"][keyPtr->second.name] = value.integerValue();
-                                        break;
-                                    case SqLite::AttributeType::Text:
-                                        _lua["data"][index]["old"][keyPtr->second.name] = value.textValue();
-                                        break;
-                                    case SqLite::AttributeType::Blob:
-                                        _lua["data"][index]["old"][keyPtr->second.name] = value.blobValue();
-                                        break;
-                                }
-                        }
-                        SqLite::BinaryDecoder decoderOldData(change.oldData().data(), change.oldData().size());
-                        for (SqLite::BinaryDecoder::Value &value : decoderOldData) {
-                            auto attributePtr = tbl->second.attributes.find(value.id());
-                            if (attributePtr != tbl->second.attributes.end())
-                                switch (value.type()) {
-                                    case SqLite::AttributeType::Integer:
-                                        _lua["data"][index]["old"][attributePtr->second.name] = value.integerValue();
-                                        break;
-                                    case SqLite::AttributeType::Real:
-                                        _lua["data"][index]["old"][attributePtr->second.name] = value.realValue();
-                                        break;
-                                    case SqLite::AttributeType::Text:
-                                        _lua["data"][index]["old"][attributePtr->second.name] = value.textValue();
-                                        break;
-                                    case SqLite::AttributeType::Blob:
-                                        _lua["data"][index]["old"][attributePtr->second.name] = value.blobValue();
-                                        break;
-                                }
-                        }
-                    } break;
-                }
-                index++;
+        for (Entities::ChangeView &change : header.changes()) {
+            auto tbl = _context->entities.find(change.entityUUID());
+            if (tbl == _context->entities.end())
+                continue;
+            const Config::Entity &entity = tbl->second;
+            const LuaPool::State::Names &names = _state->names(entity);
+            lua_createtable(L, 0, 4);
+            lua_rawgeti(L, LUA_REGISTRYINDEX, names.entity);
+            lua_setfield(L, -2, "entity");
+            switch (change.operation()) {
+                case SqLite::Operation::Insert:
+                    lua_pushliteral(L, "Add");
+                    lua_setfield(L, -2, "operation");
+                    pushRecord(L, names, entity, change.newPK(), change.newData());
+                    lua_setfield(L, -2, "new");
+                    break;
+                case SqLite::Operation::Update:
+                    lua_pushliteral(L, "Update");
+                    lua_setfield(L, -2, "operation");
+                    pushRecord(L, names, entity, change.newPK(), change.newData());
+                    lua_setfield(L, -2, "new");
+                    pushRecord(L, names, entity, change.oldPK(), change.oldData());
+                    lua_setfield(L, -2, "old");
+                    break;
+                case SqLite::Operation::Delete:
+                    lua_pushliteral(L, "Remove");
+                    lua_setfield(L, -2, "operation");
+                    pushRecord(L, names, entity, change.oldPK(), change.oldData());
+                    lua_setfield(L, -2, "old");
+                    break;
             }
+            lua_rawseti(L, -2, index++);
         }
-        if (onValidation != _onValidation.end()) {
-            return _onValidation[header.transactionUUID()]();
+        lua_setglobal(L, "data");
+        if (onValidation != _state->onValidation.end()) {
+            return onValidation->second();
         } else
             return true;
     } else
         return true;
 }
 
-bool TransactionsManager::executeCommit(Entities::Header &header) {
+bool TransactionsManager::executeCommit(Entities::Header &header, const DAO::Storage::ContextHandle &context, DAO::Storage::Batch &batch) {
     bool result = true;
-    auto onCommit = _onCommit.find(header.transactionUUID());
-    if (onCommit != _onCommit.end())
-        result = _onCommit[header.transactionUUID()]();
-    _lua.set("idDataset", sol::lua_nil);
-    _lua.set("idTransaction", sol::lua_nil);
-    _lua.set("data", sol::lua_nil);
+    _state = &LuaPool::acquire(_context, this);
+    _handle = context;
+    _batch = &batch;
+    auto onCommit = _state->onCommit.find(header.transactionUUID());
+    if (onCommit != _state->onCommit.end())
+        result = onCommit->second();
+    _state->lua.set("idDataset", sol::lua_nil);
+    _state->lua.set("idTransaction", sol::lua_nil);
+    _state->lua.set("data", sol::lua_nil);
+    _handle = DAO::Storage::ContextHandle();
+    _batch = nullptr;
     return result;
 }
 
@@ -0,0 +1,81 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <validation/ValidationBatch.hpp>
+
+#include <services/ServiceException.hpp>
+
+namespace Beehive {
+namespace Services {
+namespace Utils {
+
+ValidationBatch::Column& ValidationBatch::column(Validator *validator, const std::string &entity, const std::string &attribute) {
+  auto indexPtr = _index.find(validator);
+  if (indexPtr != _index.end())
+    return _columns[indexPtr->second];
+  _index.emplace(validator, _columns.size());
+  return _columns.emplace_back(validator, entity, attribute, _columns.get_allocator().resource());
+}
+
+void ValidationBatch::add(Validator *validator, const std::string &entity, const std::string &attribute, long value) {
+  Column &values = column(validator, entity, attribute);
+  values.integer = true;
+  values.numbers.push_back(value);
+}
+
+void ValidationBatch::add(Validator *validator, const std::string &entity, const std::string &attribute, double value) {
+  column(validator, entity, attribute).numbers.push_back(value);
+}
+
+void ValidationBatch::add(Validator *validator, const std::string &entity, const std::string &attribute, std::string_view value) {
+  column(validator, entity, attribute).texts.push_back(value);
+}
+
+void ValidationBatch::validate() {
+  std::pmr::vector<uint64_t> failures(_columns.get_allocator().resource());
+  for (Column &values : _columns) {
+    size_t size = values.numbers.empty() ? values.texts.size() : values.numbers.size();
+    failures.assign((size + 63) / 64, 0);
+    size_t failed = values.numbers.empty() ? values.validator->validate(values.texts.data(), size, failures.data()) : values.validator->validate(values.numbers.data(), size, failures.data());
+    if (failed == 0)
+      continue;
+    size_t word = 0;
+    while (failures[word] == 0)
+      word++;
+    size_t i = word * 64 + __builtin_ctzll(failures[word]);
+    std::string value;
+    if (!values.numbers.empty())
+      value = values.integer ? std::to_string(static_cast<long>(values.numbers[i])) : std::to_string(values.numbers[i]);
+    else
+      value = std::string(values.texts[i]);
+    throw DataValidationException("Not valid value[" + value + "] for attribute '" + *values.entity + "." + *values.attribute + "', the transaction will be rolled back.");
+  }
+}
+
+} /* namespace Utils */
+} /* namespace Services */
+} /* namespace Beehive */
@@ -0,0 +1,129 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <validation/Validator.hpp>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace Beehive {
+namespace Services {
+namespace Utils {
+
+std::atomic<uint64_t> Validator::_serials(0);
+
+Validator::Validator(std::string &attribute, std::string &expression, int type) :
+    _attribute(attribute), _expression(expression), _type(type), _serial(++_serials) {
+  exprtk::symbol_table<double> symbolTable;
+  exprtk::expression<double> compiled;
+  double numericValue = 0.0;
+  std::string stringValue;
+  if (type == SqLite::AttributeType::Integer || type == SqLite::AttributeType::Real) {
+    symbolTable.add_variable("value", numericValue);
+    compiled.register_symbol_table(symbolTable);
+  } else if (type == SqLite::AttributeType::Text) {
+    symbolTable.add_stringvar("value", stringValue);
+    compiled.register_symbol_table(symbolTable);
+  }
+  exprtk::parser<double> parser;
+  if (!parser.compile(expression, compiled))
+    throw Beehive::Services::InvalidSchemaException("Invalid expression check on attributes " + attribute);
+}
+
+Validator::Evaluator::Evaluator(const Validator &validator) :
+    validator(validator.weak_from_this()), numericValue(0.0) {
+  if (validator._type == SqLite::AttributeType::Integer || validator._type == SqLite::AttributeType::Real) {
+    symbolTable.add_variable("value", numericValue);
+    expression.register_symbol_table(symbolTable);
+  } else if (validator._type == SqLite::AttributeType::Text) {
+    symbolTable.add_stringvar("value", stringValue);
+    expression.register_symbol_table(symbolTable);
+  }
+  exprtk::parser<double> parser;
+  if (!parser.compile(validator._expression, expression))
+    throw Beehive::Services::InvalidSchemaException("Invalid expression check on attributes " + validator._attribute);
+}
+
+Validator::Evaluator& Validator::evaluator() {
+  thread_local std::unordered_map<uint64_t, std::unique_ptr<Evaluator>> evaluators;
+  thread_local size_t sweepAt = 64;
+  auto evaluatorPtr = evaluators.find(_serial);
+  if (evaluatorPtr != evaluators.end())
+    return *evaluatorPtr->second;
+  if (evaluators.size() >= sweepAt) {
+    for (auto it = evaluators.begin(); it != evaluators.end();) {
+      if (it->second->validator.expired())
+        it = evaluators.erase(it);
+      else
+        ++it;
+    }
+    sweepAt = std::max<size_t>(64, evaluators.size() * 2);
+  }
+  return *evaluators.emplace(_serial, std::make_unique<Evaluator>(*this)).first->second;
+}
+
+bool Validator::isValidValue(double value) {
+  Evaluator &current = evaluator();
+  current.numericValue = value;
+  return current.expression.value();
+}
+
+bool Validator::isValidValue(std::string_view value) {
+  Evaluator &current = evaluator();
+  current.stringValue.assign(value.data(), value.size());
+  return current.expression.value();
+}
+
+size_t Validator::validate(const double *values, size_t size, uint64_t *failures) {
+  Evaluator &current = evaluator();
+  size_t failed = 0;
+  for (size_t i = 0; i < size; i++) {
+    current.numericValue = values[i];
+    if (!current.expression.value()) {
+      failures[i >> 6] |= uint64_t(1) << (i & 63);
+      failed++;
+    }
+  }
+  return failed;
+}
+
+size_t Validator::validate(const std::string_view *values, size_t size, uint64_t *failures) {
+  Evaluator &current = evaluator();
+  size_t failed = 0;
+  for (size_t i = 0; i < size; i++) {
+    current.stringValue.assign(values[i].data(), values[i].size());
+    if (!current.expression.value()) {
+      failures[i >> 6] |= uint64_t(1) << (i & 63);
+      failed++;
+    }
+  }
+  return failed;
+}
+
+} /* namespace Utils */
+} /* namespace Services */
+} /* namespace Beehive */
@@ -0,0 +1,81 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Test.hpp"
+
+#include <tcp/Checksum.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace Beehive::Services::TCP;
+
+static const char Check[] = "123456789";
+
+static void checkValues() {
+  // Catalogued check values of CRC-16/ARC and CRC-32C over "123456789".
+  CHECK(crc16(0, Check, 9) == 0xBB3D);
+  CHECK(crc32c(0, Check, 9) == 0xE3069283);
+  CHECK(crc16(0, Check, 0) == 0);
+  CHECK(crc32c(0, Check, 0) == 0);
+}
+
+static void chaining() {
+  std::vector<uint8_t> data(4099);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<uint8_t>(i * 7 + 3);
+
+  uint16_t whole16 = crc16(0, data.data(), data.size());
+  uint32_t whole32 = crc32c(0, data.data(), data.size());
+
+  // Every split point, including the unaligned ones the SSE4.2 path handles
+  // byte by byte.
+  for (size_t split = 0; split <= 17; split++) {
+    CHECK(crc16(crc16(0, data.data(), split), data.data() + split, data.size() - split) == whole16);
+    CHECK(crc32c(crc32c(0, data.data(), split), data.data() + split, data.size() - split) == whole32);
+  }
+
+  uint16_t bytes16 = 0;
+  uint32_t bytes32 = 0;
+  for (uint8_t byte : data) {
+    bytes16 = crc16(bytes16, &byte, 1);
+    bytes32 = crc32c(bytes32, &byte, 1);
+  }
+  CHECK(bytes16 == whole16);
+  CHECK(bytes32 == whole32);
+
+  uint16_t check16 = crc16(crc16(0, Check, 4), Check + 4, 5);
+  uint32_t check32 = crc32c(crc32c(0, Check, 4), Check + 4, 5);
+  CHECK(check16 == 0xBB3D);
+  CHECK(check32 == 0xE3069283);
+}
+
+int main() {
+  checkValues();
+  chaining();
+  return Beehive::Test::result();
+}
@@ -0,0 +1,95 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Test.hpp"
+
+#include <sqlite/ColumnCodec.hpp>
+
+#include <string>
+#include <unordered_map>
+
+using namespace Beehive::Services;
+
+typedef std::unordered_map<std::string, int, Utils::IHasher, Utils::IEqualsComparator> Columns;
+
+static void empty() {
+  SqLite::ColumnCodec none;
+  CHECK(none.find("id") == -1);
+  CHECK(none.find("") == -1);
+
+  SqLite::ColumnCodec compiled { Columns() };
+  CHECK(compiled.find("id") == -1);
+}
+
+static void lookup() {
+  for (int count : { 1, 2, 3, 5, 17, 64, 100, 1000 }) {
+    Columns columns;
+    for (int i = 0; i < count; i++)
+      columns.emplace("Column_" + std::to_string(i * 7), i);
+    SqLite::ColumnCodec codec(columns);
+
+    for (int i = 0; i < count; i++) {
+      std::string name = std::to_string(i * 7);
+      CHECK(codec.find("Column_" + name) == i);
+      CHECK(codec.find("COLUMN_" + name) == i);
+      CHECK(codec.find("column_" + name) == i);
+      CHECK(codec.find("cOlUmN_" + name) == i);
+
+      // Misses that share a prefix, a hash bucket or a length with a column.
+      CHECK(codec.find("Column_" + name + "x") == -1);
+      CHECK(codec.find("Column" + name) == -1);
+      CHECK(codec.find("Column " + name) == -1);
+      CHECK(codec.find("Column_" + std::to_string(i * 7 + 1)) == -1);
+    }
+    CHECK(codec.find("") == -1);
+    CHECK(codec.find("Column_") == -1);
+    CHECK(codec.find("nope") == -1);
+  }
+}
+
+static void folding() {
+  // Only ASCII letters fold, the punctuation next to them in the table does
+  // not match its lower case neighbour.
+  Columns columns;
+  columns.emplace("@at", 1);
+  columns.emplace("[b]", 2);
+  columns.emplace(std::string("nul\0l", 5), 3);
+  SqLite::ColumnCodec codec(columns);
+  CHECK(codec.find("@AT") == 1);
+  CHECK(codec.find("`at") == -1);
+  CHECK(codec.find("[B]") == 2);
+  CHECK(codec.find("{b}") == -1);
+  CHECK(codec.find(std::string("NUL\0L", 5)) == 3);
+  CHECK(codec.find("nul") == -1);
+}
+
+int main() {
+  empty();
+  lookup();
+  folding();
+  return Beehive::Test::result();
+}
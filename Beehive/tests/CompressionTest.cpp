@@ -0,0 +1,124 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Test.hpp"
+
+#include <tcp/Compression.hpp>
+#include <tcp/TCPException.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace Beehive::Services::TCP;
+
+namespace {
+
+std::vector<uint8_t> rows(size_t count) {
+  std::string rows;
+  for (size_t i = 0; i < count; i++)
+    rows += "{\"id\":" + std::to_string(i) + ",\"name\":\"customer " + std::to_string(i * 31 % 97) + "\",\"city\":\"Guadalajara\"}";
+  return std::vector<uint8_t>(rows.begin(), rows.end());
+}
+
+std::vector<uint8_t> noise(size_t size) {
+  std::vector<uint8_t> noise(size);
+  uint32_t state = 2463534242u;
+  for (uint8_t &byte : noise) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    byte = (uint8_t) state;
+  }
+  return noise;
+}
+
+const Compression Algorithms[] = { Compression::LZ4, Compression::ZSTD };
+
+} /* namespace */
+
+static void roundTrip() {
+  const std::vector<uint8_t> payloads[] = { std::vector<uint8_t>(), std::vector<uint8_t>(1, 'x'), rows(1), rows(500), noise(70000) };
+  const std::vector<uint8_t> prefix = { 'h', 'e', 'a', 'd' };
+  for (Compression algorithm : Algorithms) {
+    // One compressor for every payload, like a connection reuses it for
+    // every frame.
+    Compressor compressor;
+    for (const std::vector<uint8_t> &payload : payloads) {
+      std::vector<uint8_t> compressed = prefix;
+      compressor.compress(algorithm, payload.data(), payload.size(), compressed);
+      CHECK(std::equal(prefix.begin(), prefix.end(), compressed.begin()));
+      if (payload.size() > 1000 && payload[0] == '{')
+        CHECK(compressed.size() - prefix.size() < payload.size() / 4);
+
+      std::vector<uint8_t> expanded = prefix;
+      compressor.decompress(algorithm, compressed.data() + prefix.size(), compressed.size() - prefix.size(), payload.size(), expanded);
+      CHECK(expanded.size() == prefix.size() + payload.size());
+      CHECK(std::equal(prefix.begin(), prefix.end(), expanded.begin()));
+      CHECK(std::equal(payload.begin(), payload.end(), expanded.begin() + prefix.size()));
+    }
+  }
+}
+
+static void sizeMismatch() {
+  std::vector<uint8_t> payload = rows(50);
+  for (Compression algorithm : Algorithms) {
+    Compressor compressor;
+    std::vector<uint8_t> compressed;
+    compressor.compress(algorithm, payload.data(), payload.size(), compressed);
+
+    // The size announced by the frame must be exactly the expanded size.
+    std::vector<uint8_t> expanded;
+    CHECK_THROWS(compressor.decompress(algorithm, compressed.data(), compressed.size(), payload.size() + 1, expanded), TransmissionErrorException);
+    expanded.clear();
+    CHECK_THROWS(compressor.decompress(algorithm, compressed.data(), compressed.size(), payload.size() - 1, expanded), TransmissionErrorException);
+    expanded.clear();
+    CHECK_THROWS(compressor.decompress(algorithm, compressed.data(), compressed.size() / 2, payload.size(), expanded), TransmissionErrorException);
+
+    // The compressor is still usable after a rejected frame.
+    expanded.clear();
+    compressor.decompress(algorithm, compressed.data(), compressed.size(), payload.size(), expanded);
+    CHECK(expanded == payload);
+  }
+}
+
+static void unknownDictionary() {
+  // Zstandard frame header asking for dictionary 42: magic number, a
+  // descriptor with a one byte dictionary id, window descriptor and the id.
+  const uint8_t frame[] = { 0x28, 0xb5, 0x2f, 0xfd, 0x01, 0x00, 42 };
+  Compressor compressor;
+  std::vector<uint8_t> expanded;
+  CHECK_THROWS(compressor.decompress(Compression::ZSTD, frame, sizeof(frame), 16, expanded), TransmissionErrorException);
+}
+
+int main() {
+  roundTrip();
+  sizeMismatch();
+  unknownDictionary();
+  return Beehive::Test::result();
+}
@@ -0,0 +1,244 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Test.hpp"
+
+#include <tcp/Checksum.hpp>
+#include <tcp/Message.hpp>
+#include <tcp/TCPException.hpp>
+#include <tcp/TCPHandler.hpp>
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+using namespace Beehive::Services::TCP;
+
+namespace {
+
+class Handler : public TCPHandler {
+public:
+  Handler(int socket) :
+      TCPHandler(socket) {
+    arm(std::chrono::seconds(5));
+    framing(Framing::V2);
+  }
+
+  bool resume() override {
+    return false;
+  }
+};
+
+// Both ends of a connection, a handler on one and the raw socket on the
+// other.
+class Connection {
+public:
+  Connection() {
+    socketpair(AF_UNIX, SOCK_STREAM, 0, _sockets);
+    _handler = new Handler(_sockets[0]);
+  }
+
+  ~Connection() {
+    delete _handler;
+    close(_sockets[0]);
+    if (_sockets[1] != -1)
+      close(_sockets[1]);
+  }
+
+  Handler &handler() {
+    return *_handler;
+  }
+
+  void send(const std::string &bytes) {
+    CHECK(write(_sockets[1], bytes.data(), bytes.size()) == (ssize_t) bytes.size());
+  }
+
+  std::string receive(size_t size) {
+    std::string bytes(size, '\0');
+    size_t received = 0;
+    while (received < size) {
+      ssize_t count = read(_sockets[1], bytes.data() + received, size - received);
+      if (count <= 0)
+        break;
+      received += count;
+    }
+    bytes.resize(received);
+    return bytes;
+  }
+
+  void hangUp() {
+    close(_sockets[1]);
+    _sockets[1] = -1;
+  }
+
+private:
+  int _sockets[2];
+  Handler *_handler;
+};
+
+std::string header(uint8_t operation, uint8_t flags, uint32_t length) {
+  std::string bytes;
+  bytes.push_back((char) operation);
+  bytes.push_back((char) flags);
+  length = htonl(length);
+  bytes.append((const char*) &length, sizeof(uint32_t));
+  return bytes;
+}
+
+std::string frame(uint8_t operation, uint8_t flags, const std::string &payload, Checksum checksum = Checksum::CRC16) {
+  std::string bytes = header(operation, flags, payload.size()) + payload;
+  if (checksum == Checksum::CRC32C) {
+    uint32_t crc = htonl(crc32c(0, bytes.data(), bytes.size()));
+    bytes.append((const char*) &crc, sizeof(uint32_t));
+  } else {
+    uint16_t crc = htons(crc16(0, bytes.data(), bytes.size()));
+    bytes.append((const char*) &crc, sizeof(uint16_t));
+  }
+  return bytes;
+}
+
+const uint32_t MaxFrameSize = 1048576;
+
+} /* namespace */
+
+static void layout() {
+  for (Checksum checksum : { Checksum::CRC16, Checksum::CRC32C }) {
+    Connection connection;
+    connection.handler().checksum(checksum);
+    connection.handler().beginFrame('N', false);
+    Message<U8String, U32>::write(connection.handler(), "hello", 42);
+    connection.handler().endFrame();
+    connection.handler().flush();
+
+    // op, flags, big endian payload length, payload and the checksum of
+    // header and payload with the negotiated algorithm.
+    std::string payload = std::string("\x05hello", 6) + std::string("\0\0\0\x2a", 4);
+    std::string expected = frame('N', 0, payload, checksum);
+    CHECK(connection.receive(expected.size()) == expected);
+  }
+}
+
+static void tagged() {
+  Connection connection;
+  Handler &handler = connection.handler();
+  std::string id("\x01\x02\x03\x04", 4);
+  connection.send(frame('Q', FrameFlags::Tagged, id + std::string("\x02ok", 3)));
+  CHECK(handler.readFrame() == 'Q');
+  auto [text] = Message<U8String>::receive(handler);
+  CHECK(text == "ok");
+  CHECK(handler.readChecksum() == 0);
+
+  // The reply carries the request id, a notification does not.
+  handler.beginFrame('Q');
+  handler.writeUInt8(0);
+  handler.endFrame();
+  handler.beginFrame('a', false);
+  handler.endFrame();
+  handler.flush();
+  std::string reply = frame('Q', FrameFlags::Tagged, id + std::string(1, '\0'));
+  CHECK(connection.receive(reply.size()) == reply);
+  std::string notification = frame('a', 0, "");
+  CHECK(connection.receive(notification.size()) == notification);
+}
+
+static void oversize() {
+  TCPHandler::maxFrameSize(1024);
+  {
+    Connection connection;
+    connection.send(frame('B', 0, std::string(1024, 'b')));
+    CHECK(connection.handler().readFrame() == 'B');
+  }
+  {
+    // Rejected from the header, before any of the payload arrives.
+    Connection connection;
+    connection.send(header('B', 0, 1025));
+    CHECK_THROWS(connection.handler().frameReady(), TransmissionErrorException);
+  }
+  {
+    Connection connection;
+    connection.send(header('B', 0, 0x7f000000));
+    CHECK_THROWS(connection.handler().readFrame(), TransmissionErrorException);
+  }
+  {
+    // A compressed frame may not expand past the limit either.
+    Connection connection;
+    connection.handler().compression(Compression::LZ4);
+    uint32_t expanded = htonl(1025);
+    connection.send(frame('B', FrameFlags::Compressed, std::string((const char*) &expanded, sizeof(uint32_t)) + "x"));
+    CHECK_THROWS(connection.handler().readFrame(), TransmissionErrorException);
+  }
+  TCPHandler::maxFrameSize(MaxFrameSize);
+}
+
+static void invalid() {
+  {
+    Connection connection;
+    connection.send(frame('B', 0x80, ""));
+    CHECK_THROWS(connection.handler().readFrame(), TransmissionErrorException);
+  }
+  {
+    // Compressed frames are only accepted once compression is negotiated.
+    Connection connection;
+    connection.send(frame('B', FrameFlags::Compressed, std::string(8, '\0')));
+    CHECK_THROWS(connection.handler().readFrame(), TransmissionErrorException);
+  }
+  {
+    Connection connection;
+    std::string bytes = frame('B', 0, "payload");
+    bytes.back() ^= 1;
+    connection.send(bytes);
+    CHECK_THROWS(connection.handler().readFrame(), TransmissionErrorException);
+  }
+  {
+    Connection connection;
+    connection.send(frame('B', FrameFlags::Tagged, "id"));
+    CHECK_THROWS(connection.handler().readFrame(), TransmissionErrorException);
+  }
+  {
+    Connection connection;
+    connection.send(header('B', 0, 10) + "short");
+    connection.hangUp();
+    CHECK_THROWS(connection.handler().readFrame(), TransmissionErrorException);
+  }
+  {
+    Connection connection;
+    connection.hangUp();
+    CHECK(connection.handler().readFrame() == 0);
+  }
+}
+
+int main() {
+  layout();
+  tagged();
+  oversize();
+  invalid();
+  return Beehive::Test::result();
+}
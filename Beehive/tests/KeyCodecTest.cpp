@@ -0,0 +1,124 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Test.hpp"
+
+#include <dao/KeyCodec.hpp>
+#include <dao/Storage.hpp>
+
+#include <iterator>
+#include <string>
+
+using namespace Beehive::Services::DAO;
+
+static const std::string Uuid = "0f1e2d3c-4b5a-6978-8796-a5b4c3d2e1f0";
+
+static void roundTrip() {
+  const std::string embedded("a\0b\0", 4);
+  KeyCodec key("H.");
+  key.putUint16(300).putUint32(7).putUint64(0x0102030405060708ull).putUUID(Uuid).putString(embedded).putString("").putTail(
+      std::string("t\0\xff", 3));
+
+  KeyCodec::Reader reader(key.key(), 2);
+  CHECK(reader.getUint16() == 300);
+  CHECK(reader.getUint32() == 7);
+  CHECK(reader.getUint64() == 0x0102030405060708ull);
+  CHECK(reader.getUUID() == Uuid);
+  CHECK(reader.getString() == embedded);
+  CHECK(reader.getString().empty());
+  CHECK(reader.tail() == std::string("t\0\xff", 3));
+
+  // UUIDs are stored as bytes, so they come back in lower case.
+  KeyCodec upper("");
+  upper.putUUID("0F1E2D3C-4B5A-6978-8796-A5B4C3D2E1F0");
+  CHECK(upper.key().size() == 16);
+  CHECK(KeyCodec::Reader(upper.key(), 0).getUUID() == Uuid);
+}
+
+static void ordering() {
+  CHECK(KeyCodec("H.").putUint32(1).putUint32(255).key() < KeyCodec("H.").putUint32(1).putUint32(256).key());
+  CHECK(KeyCodec("H.").putUint32(255).key() < KeyCodec("H.").putUint32(0x80000000).key());
+  CHECK(KeyCodec("H.").putUint64(0xffffffffull).key() < KeyCodec("H.").putUint64(0x100000000ull).key());
+
+  // A string sorts before its extensions, including the ones starting with
+  // an embedded "\0", whatever follows it in the key.
+  const std::string strings[] = {
+    "", std::string("\0", 1), std::string("\0\0", 2), "\x01", "ab", std::string("ab\0", 3), std::string("ab\0c", 4),
+    "ab\x01", "abc", "b"
+  };
+  for (size_t i = 0; i + 1 < std::size(strings); i++) {
+    CHECK(KeyCodec("").putString(strings[i]).key() < KeyCodec("").putString(strings[i + 1]).key());
+    CHECK(KeyCodec("").putString(strings[i]).putUint32(0xffffffff).key() <
+          KeyCodec("").putString(strings[i + 1]).putUint32(0).key());
+  }
+}
+
+static void successor() {
+  KeyCodec dataset("C.");
+  dataset.putUint32(7);
+  std::string end = dataset.successor();
+  CHECK(dataset.key() < end);
+  CHECK(KeyCodec("C.").putUint32(7).putUint32(0xffffffff).putString("zzz").key() < end);
+  CHECK(end == KeyCodec("C.").putUint32(8).key());
+
+  // Trailing 0xff bytes can not be incremented, they are dropped instead.
+  KeyCodec carry("C.");
+  carry.putUint32(0x1ff);
+  CHECK(carry.successor() == std::string("C.\0\0\x02", 5));
+  CHECK(KeyCodec("C.").putUint32(0x1ff).putUint64(0xffffffffffffffffull).key() < carry.successor());
+  CHECK(carry.successor() <= KeyCodec("C.").putUint32(0x200).key());
+
+  // A key made only of 0xff has no upper bound.
+  CHECK(KeyCodec("\xff\xff").successor().empty());
+
+  KeyCodec string("S.");
+  string.putString("ab");
+  CHECK(KeyCodec("S.").putString("ab").putTail("\xff\xff").key() < string.successor());
+  CHECK(string.successor() <= KeyCodec("S.").putString(std::string("ab\0", 3)).key());
+}
+
+static void malformed() {
+  CHECK_THROWS(KeyCodec("").putUUID("0f1e2d3c4b5a69788796a5b4c3d2e1f0"), StorageException);
+  CHECK_THROWS(KeyCodec("").putUUID("0f1e2d3c-4b5a-6978-8796-a5b4c3d2e1fg"), StorageException);
+
+  // Readers only view the key, so the keys outlive them.
+  const std::string shortKey("\0\0\0", 3);
+  const std::string shortUuid(15, 'u');
+  const std::string badEscape("a\0b", 3);
+  CHECK_THROWS(KeyCodec::Reader(shortKey, 0).getUint32(), StorageException);
+  CHECK_THROWS(KeyCodec::Reader(shortUuid, 0).getUUID(), StorageException);
+  CHECK_THROWS(KeyCodec::Reader("abc", 0).getString(), StorageException);
+  CHECK_THROWS(KeyCodec::Reader(badEscape, 0).getString(), StorageException);
+}
+
+int main() {
+  roundTrip();
+  ordering();
+  successor();
+  malformed();
+  return Beehive::Test::result();
+}
@@ -0,0 +1,151 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Test.hpp"
+
+#include <tcp/Message.hpp>
+#include <tcp/TCPHandler.hpp>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+using namespace Beehive::Services::TCP;
+
+namespace {
+
+class Handler : public TCPHandler {
+public:
+  Handler(int socket) :
+      TCPHandler(socket) {
+    arm(std::chrono::seconds(5));
+  }
+
+  bool resume() override {
+    return false;
+  }
+};
+
+const std::string Uuid = "0f1e2d3c-4b5a-6978-8796-a5b4c3d2e1f0";
+
+typedef Message<U8, U16, U32, U64, U8String, U16String, UUID> Everything;
+
+} /* namespace */
+
+static void roundTrip(Handler &client, Handler &server) {
+  std::string large(65535, 'l');
+  for (Checksum checksum : { Checksum::CRC16, Checksum::CRC32C }) {
+    client.checksum(checksum);
+    server.checksum(checksum);
+    Everything::write(client, 0xfe, 0xfedc, 0xfedcba98, 0xfedcba9876543210ull, "", large, Uuid);
+    client.flush();
+    auto [u8, u16, u32, u64, short_, long_, uuid] = Everything::read(server);
+    CHECK(u8 == 0xfe);
+    CHECK(u16 == 0xfedc);
+    CHECK(u32 == 0xfedcba98);
+    CHECK(u64 == 0xfedcba9876543210ull);
+    CHECK(short_.empty());
+    CHECK(long_ == large);
+    CHECK(uuid == Uuid);
+  }
+  client.checksum(Checksum::CRC16);
+  server.checksum(Checksum::CRC16);
+}
+
+static void legacy(Handler &client, Handler &server) {
+  // The templates read what the field by field writers send and the other
+  // way around, checksum included.
+  typedef Message<U16String, U8, UUID, U32> Legacy;
+  uint32_t crc = 0;
+  client.writeUInt16C(3, crc);
+  client.writeCharC("abc", 3, crc);
+  client.writeUInt8C(1, crc);
+  client.writeUUIDC(Uuid.data(), crc);
+  client.writeUInt32C(99, crc);
+  client.writeChecksum(crc);
+  client.flush();
+  auto [string, number, uuid, last] = Legacy::read(server);
+  CHECK(string == "abc");
+  CHECK(number == 1);
+  CHECK(uuid == Uuid);
+  CHECK(last == 99);
+
+  Legacy::write(server, "xyz", 2, Uuid, 7);
+  server.flush();
+  crc = 0;
+  char chars[36];
+  CHECK(client.readUInt16C(crc) == 3);
+  client.readCharC(chars, 3, crc);
+  CHECK(std::string(chars, 3) == "xyz");
+  CHECK(client.readUInt8C(crc) == 2);
+  client.readUUIDC(chars, crc);
+  CHECK(std::string(chars, 36) == Uuid);
+  CHECK(client.readUInt32C(crc) == 7);
+  CHECK(client.readChecksum() == crc);
+}
+
+static void corrupted(Handler &client, Handler &server) {
+  typedef Message<U8String> Text;
+  uint32_t crc = 0;
+  client.writeUInt8C(5, crc);
+  client.writeCharC("hello", 5, crc);
+  client.writeChecksum(crc ^ 1);
+  client.flush();
+  CHECK_THROWS(Text::read(server), TransmissionErrorException);
+
+  // The message without checksum is still received.
+  Text::write(client, "again");
+  client.flush();
+  auto [text] = Text::receive(server);
+  CHECK(text == "again");
+  server.readChecksum();
+}
+
+static void invalid(Handler &client) {
+  CHECK_THROWS(Message<U8String>::write(client, std::string(256, 'x')), std::invalid_argument);
+  CHECK_THROWS(Message<UUID>::write(client, Uuid.substr(1)), std::invalid_argument);
+}
+
+int main() {
+  int sockets[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+    return 1;
+  {
+    Handler server(sockets[0]);
+    Handler client(sockets[1]);
+    roundTrip(client, server);
+    legacy(client, server);
+    corrupted(client, server);
+    invalid(client);
+  }
+  close(sockets[0]);
+  close(sockets[1]);
+  return Beehive::Test::result();
+}
@@ -0,0 +1,166 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Test.hpp"
+
+#include <dao/Record.hpp>
+#include <dao/Storage.hpp>
+
+#include <cstdint>
+#include <string>
+
+using namespace Beehive::Services;
+
+static Entities::User user() {
+  Entities::User user;
+  user.uuid("4a9c2f43-7c3f-4b7e-9a52-1f0c8e2d6b11");
+  user.identifier("someone@example.com");
+  user.name(std::string(300, 'n'));
+  user.type(Entities::User::Type::google);
+  user.password("password");
+  user.salt("salt");
+  return user;
+}
+
+static void roundTrip() {
+  Entities::Node node;
+  node.user(user());
+  node.key(std::string("\0\x01key\xff", 6));
+  node.context("context");
+  node.module("module");
+  node.uuid("9d3e57a0-2f1b-4c7d-8e6f-0a1b2c3d4e5f");
+  node.version(0xfffffffe);
+
+  Entities::Node decoded;
+  DAO::Record::decode(DAO::Record::encode(node), decoded);
+  CHECK(decoded.user().uuid() == node.user().uuid());
+  CHECK(decoded.user().identifier() == node.user().identifier());
+  CHECK(decoded.user().name() == node.user().name());
+  CHECK(decoded.user().type() == Entities::User::Type::google);
+  CHECK(decoded.user().password() == "password");
+  CHECK(decoded.user().salt() == "salt");
+  CHECK(decoded.key() == node.key());
+  CHECK(decoded.context() == "context");
+  CHECK(decoded.module() == "module");
+  CHECK(decoded.uuid() == node.uuid());
+  CHECK(decoded.version() == 0xfffffffe);
+
+  Entities::Header header;
+  header.idDataset(3);
+  header.idHeader(0xffffffff);
+  header.transactionUUID("tx");
+  header.node(5);
+  header.idNode(6);
+  header.status(2);
+  header.version(7);
+  Entities::Header decodedHeader;
+  DAO::Record::decode(DAO::Record::encode(header), decodedHeader);
+  CHECK(decodedHeader.idDataset() == 3);
+  CHECK(decodedHeader.idHeader() == 0xffffffff);
+  CHECK(decodedHeader.transactionUUID() == "tx");
+  CHECK(decodedHeader.node() == 5);
+  CHECK(decodedHeader.idNode() == 6);
+  CHECK(decodedHeader.status() == 2);
+  CHECK(decodedHeader.version() == 7);
+}
+
+static void unknownFields() {
+  // Fields from a newer version are skipped whatever their wire type and
+  // missing ones keep their defaults.
+  DAO::Record::Writer writer(DAO::Record::Type::user);
+  writer.put(1, "uuid");
+  writer.put(99, UINT64_MAX);
+  writer.put(100, std::string(200, 'x'));
+  writer.put(2, "identifier");
+  writer.put(0x0fffffff, "last");
+
+  Entities::User decoded;
+  DAO::Record::decode(writer.data(), decoded);
+  CHECK(decoded.uuid() == "uuid");
+  CHECK(decoded.identifier() == "identifier");
+  CHECK(decoded.type() == Entities::User::Type::unknown);
+
+  DAO::Record::Reader reader(writer.data(), DAO::Record::Type::user);
+  CHECK(reader.next() && reader.field() == 1 && reader.bytes() == "uuid");
+  CHECK(reader.next() && reader.field() == 99 && reader.integer() == UINT64_MAX);
+  CHECK(reader.next() && reader.field() == 100 && reader.bytes().size() == 200);
+  CHECK(reader.next() && reader.field() == 2);
+  CHECK(reader.next() && reader.field() == 0x0fffffff && reader.bytes() == "last");
+  CHECK(!reader.next());
+}
+
+static void jsonFallback() {
+  Entities::User original = user();
+  nlohmann::json json = original;
+  Entities::User decoded;
+  DAO::Record::decode(json.dump(), decoded);
+  CHECK(decoded.uuid() == original.uuid());
+  CHECK(decoded.identifier() == original.identifier());
+  CHECK(decoded.name() == original.name());
+  CHECK(decoded.type() == Entities::User::Type::google);
+
+  Entities::Node node;
+  node.user(original);
+  node.key(std::string("\0k", 2));
+  node.context("context");
+  node.module("module");
+  node.uuid("uuid");
+  node.version(9);
+  nlohmann::json nodeJson = node;
+  Entities::Node decodedNode;
+  DAO::Record::decode(nodeJson.dump(), decodedNode);
+  CHECK(decodedNode.user().identifier() == original.identifier());
+  CHECK(decodedNode.key() == node.key());
+  CHECK(decodedNode.version() == 9);
+}
+
+static void malformed() {
+  std::string valid = DAO::Record::encode(user());
+  Entities::User decoded;
+  Entities::Node node;
+
+  CHECK_THROWS(DAO::Record::decode("", decoded), DAO::StorageException);
+  CHECK_THROWS(DAO::Record::decode(valid, node), DAO::StorageException);
+
+  std::string version = valid;
+  version[0] = static_cast<char>(DAO::Record::Version + 1);
+  CHECK_THROWS(DAO::Record::decode(version, decoded), DAO::StorageException);
+
+  // Cut inside the value of the name, whose length is larger than the rest.
+  CHECK_THROWS(DAO::Record::decode(valid.substr(0, valid.size() / 2), decoded), DAO::StorageException);
+
+  std::string varint = valid.substr(0, 2) + "\x80";
+  CHECK_THROWS(DAO::Record::decode(varint, decoded), DAO::StorageException);
+}
+
+int main() {
+  roundTrip();
+  unknownFields();
+  jsonFallback();
+  malformed();
+  return Beehive::Test::result();
+}
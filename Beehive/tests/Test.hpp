@@ -0,0 +1,69 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for the CTest executables. A failed check reports where it
+// happened and keeps going, main() returns Test::result() so CTest sees every
+// failure of a run instead of only the first one.
+namespace Beehive {
+namespace Test {
+
+inline int failures = 0;
+
+inline void fail(const char *file, int line, const char *condition) {
+  std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+  failures++;
+}
+
+inline int result() {
+  return failures == 0 ? 0 : 1;
+}
+
+} /* namespace Test */
+} /* namespace Beehive */
+
+#define CHECK(condition) \
+  do { \
+    if (!(condition)) \
+      Beehive::Test::fail(__FILE__, __LINE__, #condition); \
+  } while (false)
+
+// Checks that the statement throws the given exception type.
+#define CHECK_THROWS(statement, exception) \
+  do { \
+    bool thrown = false; \
+    try { \
+      statement; \
+    } catch (exception&) { \
+      thrown = true; \
+    } \
+    if (!thrown) \
+      Beehive::Test::fail(__FILE__, __LINE__, #statement " throws " #exception); \
+  } while (false)
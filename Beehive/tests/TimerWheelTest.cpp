@@ -0,0 +1,107 @@
+/*
+Beehive - SQLite synchronization server.
+
+MIT License
+
+Copyright (c) 2021 Edgar Malagón Calderón
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Test.hpp"
+
+#include <tcp/TimerWheel.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace Beehive::Services::TCP;
+
+// How late a timer may fire on a loaded machine before the test fails.
+static const std::chrono::milliseconds Slack(50);
+
+static void cascading() {
+  // Deadlines around the slot boundaries of the first three levels, with a
+  // 1 ms resolution a level 0 slot is 1 ms, level 1 is 64 ms and level 2 is
+  // 4096 ms. Timers past 64 ticks can only fire on time if they cascade.
+  const std::vector<int> deadlines = {
+    1, 2, 63, 64, 65, 127, 128, 129, 200, 1000, 4095, 4096, 4097, 4300
+  };
+
+  auto begin = std::chrono::steady_clock::now();
+  TimerWheel wheel(std::chrono::milliseconds(1));
+  CHECK(wheel.timeout() == -1);
+  CHECK(wheel.advance() == nullptr);
+
+  std::vector<TimerWheel::Timer> timers(deadlines.size());
+  for (size_t i = 0; i < deadlines.size(); i++)
+    wheel.schedule(&timers[i], std::chrono::milliseconds(deadlines[i]));
+
+  TimerWheel::Timer cancelled;
+  wheel.schedule(&cancelled, std::chrono::milliseconds(100));
+  wheel.cancel(&cancelled);
+  CHECK(!cancelled.scheduled());
+
+  // Scheduling again moves the timer instead of adding a second entry.
+  TimerWheel::Timer moved;
+  wheel.schedule(&moved, std::chrono::milliseconds(50));
+  wheel.schedule(&moved, std::chrono::milliseconds(300));
+
+  std::vector<std::chrono::milliseconds> fired(deadlines.size(), std::chrono::milliseconds(-1));
+  std::chrono::milliseconds movedFired(-1);
+  size_t pending = deadlines.size() + 1;
+  while (pending > 0) {
+    int timeout = wheel.timeout();
+    CHECK(timeout >= 0);
+    if (timeout < 0)
+      break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+    for (TimerWheel::Timer *timer = wheel.advance(); timer != nullptr; timer = TimerWheel::next(timer)) {
+      CHECK(!timer->scheduled());
+      if (timer == &moved) {
+        CHECK(movedFired.count() < 0);
+        movedFired = elapsed;
+      } else {
+        CHECK(timer != &cancelled);
+        size_t i = timer - timers.data();
+        CHECK(fired[i].count() < 0);
+        fired[i] = elapsed;
+      }
+      pending--;
+    }
+  }
+
+  for (size_t i = 0; i < deadlines.size(); i++) {
+    CHECK(fired[i] >= std::chrono::milliseconds(deadlines[i]));
+    CHECK(fired[i] <= std::chrono::milliseconds(deadlines[i]) + Slack);
+  }
+  CHECK(movedFired >= std::chrono::milliseconds(300));
+  CHECK(movedFired <= std::chrono::milliseconds(300) + Slack);
+
+  CHECK(wheel.timeout() == -1);
+  CHECK(wheel.advance() == nullptr);
+}
+
+int main() {
+  cascading();
+  return Beehive::Test::result();
+}